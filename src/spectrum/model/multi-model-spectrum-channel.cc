@@ -224,6 +224,11 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   m_txSigParamsTrace (txParamsTrace);
 
   Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility ();
+  if (m_spectrumPropagationLoss && m_spectrumPropagationLoss->DoCalculateRxPowerAtReceiverSide ())
+    {
+      // the copies delivered to the receivers inherit what is resolved for the transmission
+      m_spectrumPropagationLoss->PrepareTransmission (txParams);
+    }
   SpectrumModelUid_t txSpectrumModelUid = txParams->psd->GetSpectrumModelUid ();
   NS_LOG_LOGIC ("txSpectrumModelUid " << txSpectrumModelUid);
 
@@ -271,7 +276,11 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
             {
               NS_LOG_LOGIC ("copying signal parameters " << txParams);
               Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+              if (convertedTxPowerSpectrum != txParams->psd)
+                {
+                  // Copy () already gave the receiver its own copy of the unconverted PSD
+                  rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+                }
               Time delay = MicroSeconds (0);
 
               Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
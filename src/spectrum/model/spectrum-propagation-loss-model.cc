@@ -86,6 +86,11 @@ SpectrumPropagationLossModel::SupportMimoSystemPowerCalculation (void) const
   return false;
 }
 
+void
+SpectrumPropagationLossModel::PrepareTransmission (Ptr<SpectrumSignalParameters> params) const
+{
+}
+
 Ptr<SpectrumValue>
 SpectrumPropagationLossModel::CalcRxPower (Ptr<SpectrumSignalParameters> rxParams,
                                            Ptr<const MobilityModel> a,
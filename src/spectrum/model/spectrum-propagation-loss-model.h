@@ -87,6 +87,14 @@ public:
    * \return Return true if we support calculating the received power for MIMO system, otherwise false.
    */
   virtual bool SupportMimoSystemPowerCalculation (void) const;
+  /**
+   * This method is called once per transmission, before the signal is delivered to the
+   * receivers, when the received power is calculated at the receiver side. It lets the
+   * model resolve the transmitter once instead of for every receiver.
+   *
+   * \param params the SpectrumSignalParameters of the transmitted signal.
+   */
+  virtual void PrepareTransmission (Ptr<SpectrumSignalParameters> params) const;
   /**
    * This method is to be called to calculate PSD at the receiver side.
    *
@@ -0,0 +1,68 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015-2020 IMDEA Networks Institute
+ * Copyright (c) 2018-2020 National Institute of Standards and Technology (NIST)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program converts the Q-D channel text files of a scenario
+// (WigigFiles/QdChannel/<Scenario>/QdFiles/Tx<i>Rx<j>.txt) into the binary
+// Q-D format. The binary files are written next to the text files and are
+// picked automatically by the QdPropagationEngine, which maps them in memory
+// instead of parsing the text files. A binary file is ignored once its text
+// file has been modified, so rerun the converter after regenerating the traces.
+//
+// Usage: ./waf --run "qd-channel-converter --qdChannelFolder=WigigFiles/QdChannel/SU-MIMO-Scenarios/"
+
+#include "ns3/command-line.h"
+#include "ns3/log.h"
+#include "ns3/qd-channel-store.h"
+
+#include <iostream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("QdChannelConverter");
+
+int main (int argc, char *argv[])
+{
+  std::string qdChannelFolder = "WigigFiles/QdChannel/SingleNodeMobility/";
+  std::string textFile;
+
+  CommandLine cmd;
+  cmd.AddValue ("qdChannelFolder", "Q-D channel folder whose QdFiles are converted", qdChannelFolder);
+  cmd.AddValue ("textFile", "Convert a single Q-D text file instead of a whole folder", textFile);
+  cmd.Parse (argc, argv);
+
+  if (!textFile.empty ())
+    {
+      std::string binaryFile = QdChannelStore::GetBinaryFileName (textFile);
+      if (!QdChannelStore::ConvertTextFile (textFile, binaryFile))
+        {
+          std::cerr << "Failed to convert " << textFile << std::endl;
+          return 1;
+        }
+      std::cout << "Converted " << textFile << " into " << binaryFile << std::endl;
+      return 0;
+    }
+
+  if (qdChannelFolder.empty () || qdChannelFolder[qdChannelFolder.size () - 1] != '/')
+    {
+      qdChannelFolder += "/";
+    }
+  uint32_t converted = QdChannelStore::ConvertFolder (qdChannelFolder);
+  std::cout << "Converted " << converted << " Q-D files in " << qdChannelFolder << "QdFiles" << std::endl;
+  return 0;
+}
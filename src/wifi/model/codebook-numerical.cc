@@ -313,6 +313,7 @@ CodebookNumerical::ChangeAntennaOrientation (AntennaID antennaID, double orienta
                        sectorConfig->directivity + uint (orientation),
                        sectorConfig->directivity + AZIMUTH_CARDINALITY);
         }
+      m_patternVersion++;
     }
   else
     {
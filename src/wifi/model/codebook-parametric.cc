@@ -4,7 +4,10 @@
  * Author: Hany Assasa <hany.assasa@gmail.com>
  */
 #include "ns3/log.h"
+#include "ns3/simulator.h"
 #include "ns3/string.h"
+#include "ns3/system-thread.h"
+#include "ns3/uinteger.h"
 #include "codebook-parametric.h"
 
 #include <algorithm>
@@ -17,6 +20,10 @@ NS_LOG_COMPONENT_DEFINE ("CodebookParametric");
 
 NS_OBJECT_ENSURE_REGISTERED (CodebookParametric);
 
+static_assert (PATTERN_PLANE_STRIDE >= PATTERN_CARDINALITY
+               && (PATTERN_PLANE_STRIDE * sizeof (Complex)) % PATTERN_BUFFER_ALIGNMENT == 0,
+               "Each steering vector plane must start on a cache line");
+
 float
 CalculateNormalizationFactor (WeightsVector &weightsVector)
 {
@@ -58,57 +65,202 @@ ParametricPatternConfig::GetArrayPattern (void) const
 }
 
 Complex
-ParametricPatternConfig::GetArrayPattern (uint16_t azimuthAngle, uint16_t elevationAngle)
+ParametricPatternConfig::GetArrayPattern (uint16_t azimuthAngle, uint16_t elevationAngle) const
 {
-  return arrayPatternMap[std::make_pair (azimuthAngle, elevationAngle)];
+  if (arrayPattern != 0)
+    {
+      return GetArrayPatternValue (azimuthAngle, elevationAngle);
+    }
+  NS_ASSERT_MSG (lazyArrayPattern != 0, "The array pattern has not been initialized");
+  return lazyArrayPattern->GetValue (azimuthAngle, elevationAngle);
 }
 
-void
-ParametricPatternConfig::CalculateArrayPattern (Ptr<ParametricAntennaConfig> antennaConfig,
-                                                uint16_t azimuthAngle, uint16_t elevationAngle)
+/****** Lazy Array Pattern ******/
+
+LazyArrayPattern::LazyArrayPattern (SteeringVector steeringVector, DirectivityMatrix directivity,
+                                    const WeightsVector &weights)
+  : m_steeringVector (steeringVector),
+    m_directivity (directivity),
+    m_weights (weights)
 {
-  PatternAngles angles = std::make_pair (azimuthAngle, elevationAngle);
-  ArrayPatternMapCI it = arrayPatternMap.find (angles);
-  if (it == arrayPatternMap.end ())
+  for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
     {
-      Complex value = 0;
-      uint16_t j = 0;
-      for (WeightsVectorCI it = m_weights.begin (); it != m_weights.end (); it++, j++)
-        {
-          value += (*it) * antennaConfig->steeringVector [azimuthAngle][elevationAngle][j];
-        }
-      value *= antennaConfig->singleElementDirectivity[azimuthAngle][elevationAngle];
-      arrayPatternMap[angles] = value;
+      m_rows[m].store (0, std::memory_order_relaxed);
+    }
+  for (size_t i = 0; i < (PATTERN_CARDINALITY + 63) / 64; i++)
+    {
+      m_known[i].store (0, std::memory_order_relaxed);
+    }
+}
+
+LazyArrayPattern::~LazyArrayPattern ()
+{
+  for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
+    {
+      delete[] m_rows[m].load (std::memory_order_relaxed);
+    }
+}
+
+Complex
+LazyArrayPattern::GetValue (uint16_t azimuthAngle, uint16_t elevationAngle)
+{
+  size_t index = GetPatternIndex (azimuthAngle, elevationAngle);
+  uint64_t bit = uint64_t (1) << (index % 64);
+  if (m_known[index / 64].load (std::memory_order_acquire) & bit)
+    {
+      return m_rows[azimuthAngle].load (std::memory_order_relaxed)[elevationAngle];
+    }
+
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (m_mutex);
+#endif
+  Complex *row = m_rows[azimuthAngle].load (std::memory_order_relaxed);
+  if (m_known[index / 64].load (std::memory_order_relaxed) & bit)
+    {
+      /* Another thread calculated the value while we were waiting */
+      return row[elevationAngle];
+    }
+  if (row == 0)
+    {
+      row = new Complex[ELEVATION_CARDINALITY];
+      m_rows[azimuthAngle].store (row, std::memory_order_relaxed);
+    }
+  Complex value = 0;
+  size_t offset = index;
+  for (WeightsVectorCI it = m_weights.begin (); it != m_weights.end (); it++, offset += PATTERN_PLANE_STRIDE)
+    {
+      value += (*it) * (*m_steeringVector)[offset];
     }
+  value *= (*m_directivity)[index];
+  row[elevationAngle] = value;
+  m_known[index / 64].fetch_or (bit, std::memory_order_release);
+  return value;
 }
 
 /****** Parametric Antenna Configuration ******/
 
+/**
+ * Blocks of directions whose array patterns are computed by the same thread.
+ */
+struct ArrayPatternJob
+{
+  const Complex *steering;                      //!< The steering matrix of the antenna array.
+  const Directivity *directivity;               //!< The directivity of a single antenna element.
+  const std::vector<WeightsVector> *weights;    //!< The weights vector of each pattern.
+  std::vector<Complex *> patterns;              //!< The values of each pattern.
+  size_t firstBlock;                            //!< The first block of directions.
+  size_t lastBlock;                             //!< The block of directions following the last one.
+
+  /**
+   * Compute the array patterns over the blocks of directions of the job.
+   */
+  void Run (void);
+};
+
 void
-ParametricAntennaConfig::CalculateArrayPattern (WeightsVector weights, ArrayPattern &arrayPattern)
+ArrayPatternJob::Run (void)
 {
-  arrayPattern = new Complex *[AZIMUTH_CARDINALITY];
-  for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
+  /* Real and imaginary parts are accumulated separately so that the compiler vectorizes the
+   * complex multiply-add over the directions of a block */
+  alignas (PATTERN_BUFFER_ALIGNMENT) float re[PATTERN_BLOCK_SIZE];
+  alignas (PATTERN_BUFFER_ALIGNMENT) float im[PATTERN_BLOCK_SIZE];
+  for (size_t block = firstBlock; block < lastBlock; block++)
     {
-      arrayPattern[m] = new Complex[ELEVATION_CARDINALITY];
-      for (uint16_t n = 0; n < ELEVATION_CARDINALITY; n++)
+      size_t first = block * PATTERN_BLOCK_SIZE;
+      size_t size = std::min<size_t> (PATTERN_BLOCK_SIZE, PATTERN_CARDINALITY - first);
+      for (size_t pattern = 0; pattern < patterns.size (); pattern++)
         {
-          Complex value = 0;
-          uint16_t j = 0;
-          for (WeightsVectorCI it = weights.begin (); it != weights.end (); it++, j++)
+          const WeightsVector &awv = (*weights)[pattern];
+          std::fill_n (re, size, 0.0f);
+          std::fill_n (im, size, 0.0f);
+          for (size_t element = 0; element < awv.size (); element++)
             {
-              value += (*it) * steeringVector[m][n][j];
+              float wRe = awv[element].real ();
+              float wIm = awv[element].imag ();
+              const float *values = reinterpret_cast<const float *> (steering + element * PATTERN_PLANE_STRIDE + first);
+              for (size_t i = 0; i < size; i++)
+                {
+                  re[i] += wRe * values[2 * i] - wIm * values[2 * i + 1];
+                  im[i] += wRe * values[2 * i + 1] + wIm * values[2 * i];
+                }
+            }
+          float *values = reinterpret_cast<float *> (patterns[pattern] + first);
+          for (size_t i = 0; i < size; i++)
+            {
+              values[2 * i] = re[i] * directivity[first + i];
+              values[2 * i + 1] = im[i] * directivity[first + i];
             }
-          value *= singleElementDirectivity[m][n];
-          arrayPattern[m][n] = value;
         }
     }
 }
 
+void
+ParametricAntennaConfig::CalculateArrayPattern (WeightsVector weights, ArrayPattern &arrayPattern)
+{
+  std::vector<WeightsVector> weightsList (1, weights);
+  std::vector<ArrayPattern> arrayPatterns;
+  CalculateArrayPatterns (weightsList, arrayPatterns, 1);
+  arrayPattern = arrayPatterns.front ();
+}
+
+void
+ParametricAntennaConfig::CalculateArrayPatterns (const std::vector<WeightsVector> &weights,
+                                                 std::vector<ArrayPattern> &arrayPatterns, uint8_t threads)
+{
+  NS_LOG_FUNCTION (this << weights.size () << uint16_t (threads));
+  /* Patterns may be shared with cloned codebooks, so we always write into new buffers */
+  std::vector<Complex *> values;
+  arrayPatterns.clear ();
+  for (std::vector<WeightsVector>::const_iterator it = weights.begin (); it != weights.end (); it++)
+    {
+      Ptr<ComplexBuffer> pattern = Create<ComplexBuffer> (PATTERN_CARDINALITY);
+      values.push_back (pattern->GetData ());
+      arrayPatterns.push_back (pattern);
+    }
+  if (weights.empty ())
+    {
+      return;
+    }
+
+  /* Split the blocks of directions evenly between the threads */
+  size_t numBlocks = (PATTERN_CARDINALITY + PATTERN_BLOCK_SIZE - 1) / PATTERN_BLOCK_SIZE;
+#ifndef HAVE_PTHREAD_H
+  threads = 1;
+#endif
+  threads = std::max<size_t> (1, std::min<size_t> (threads, numBlocks));
+  std::vector<ArrayPatternJob> jobs (threads);
+  for (uint8_t i = 0; i < threads; i++)
+    {
+      ArrayPatternJob &job = jobs[i];
+      job.steering = steeringVector->GetData ();
+      job.directivity = singleElementDirectivity->GetData ();
+      job.weights = &weights;
+      job.patterns = values;
+      job.firstBlock = numBlocks * i / threads;
+      job.lastBlock = numBlocks * (i + 1) / threads;
+    }
+#ifdef HAVE_PTHREAD_H
+  std::vector<Ptr<SystemThread> > workers;
+  for (uint8_t i = 1; i < threads; i++)
+    {
+      Ptr<SystemThread> worker = Create<SystemThread> (MakeCallback (&ArrayPatternJob::Run, &jobs[i]));
+      worker->Start ();
+      workers.push_back (worker);
+    }
+#endif
+  jobs.front ().Run ();
+#ifdef HAVE_PTHREAD_H
+  for (std::vector<Ptr<SystemThread> >::iterator it = workers.begin (); it != workers.end (); it++)
+    {
+      (*it)->Join ();
+    }
+#endif
+}
+
 Complex
 ParametricAntennaConfig::GetQuasiOmniArrayPatternValue (uint16_t azimuthAngle, uint16_t elevationAngle) const
 {
-  return GetQuasiOmniConfig ()->arrayPatternMap[std::make_pair (azimuthAngle, elevationAngle)];
+  return GetQuasiOmniConfig ()->GetArrayPattern (azimuthAngle, elevationAngle);
 }
 
 Ptr<ParametricPatternConfig>
@@ -160,6 +312,19 @@ CodebookParametric::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&CodebookParametric::m_precalculatedPatterns),
                    MakeBooleanChecker ())
+    .AddAttribute ("PatternThreads",
+                   "The number of threads computing the beam patterns when they are precalculated."
+                   " The patterns do not depend on the number of threads.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&CodebookParametric::m_patternThreads),
+                   MakeUintegerChecker<uint8_t> (1, 64))
+    .AddAttribute ("ShareCodebook",
+                   "Whether codebooks loaded from the same file with the same parameters share its content."
+                   " The file is read and its beam patterns are calculated once, and the following codebooks"
+                   " copy the sectors and share the steering vectors and the beam patterns of the first one.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&CodebookParametric::m_shareCodebook),
+                   MakeBooleanChecker ())
     .AddAttribute ("MimoCodebook",
                    "Special case to handle codebook of identical PAAs for MIMO communication.",
                    BooleanValue (false),
@@ -182,71 +347,12 @@ CodebookParametric::GetTypeId (void)
 CodebookParametric::CodebookParametric ()
 {
   NS_LOG_FUNCTION (this);
-  m_cloned = false;
-}
-
-void
-CodebookParametric::DisposeAntennaConfig (Ptr<ParametricAntennaConfig> antennaConfig)
-{
-  /* Iterate over all the sectors */
-  for (SectorListI sectorIter = antennaConfig->sectorList.begin ();
-       sectorIter != antennaConfig->sectorList.end (); sectorIter++)
-    {
-      Ptr<ParametricSectorConfig> sectorConfig = DynamicCast<ParametricSectorConfig> (sectorIter->second);
-      for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
-        {
-          delete[] sectorConfig->arrayPattern[m];
-        }
-      delete[] sectorConfig->arrayPattern;
-      /* Iterate over all the custom AWVs */
-      for (AWV_LIST_I awvIt = sectorConfig->awvList.begin (); awvIt != sectorConfig->awvList.end (); awvIt++)
-        {
-          Ptr<Parametric_AWV_Config> awvConfig = DynamicCast<Parametric_AWV_Config> (*awvIt);
-          for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
-            {
-              delete[] awvConfig->arrayPattern[m];
-            }
-          delete[] awvConfig->arrayPattern;
-        }
-    }
-
-  for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
-    {
-      delete[] antennaConfig->singleElementDirectivity[m];
-      delete[] antennaConfig->GetQuasiOmniConfig ()->arrayPattern[m];
-      for (uint16_t n = 0; n < ELEVATION_CARDINALITY; n++)
-        {
-          delete[] antennaConfig->steeringVector[m][n];
-        }
-      delete[] antennaConfig->steeringVector[m];
-    }
-
-  // Free the array of pointers
-  delete[] antennaConfig->singleElementDirectivity;
-  delete[] antennaConfig->GetQuasiOmniConfig ()->arrayPattern;
-  delete[] antennaConfig->steeringVector;
 }
 
 void
 CodebookParametric::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
-  if (!m_cloned)
-    {
-      if (m_mimoCodebook)
-        {
-          /* Iterate over all the antenna arrays */
-          DisposeAntennaConfig (StaticCast<ParametricAntennaConfig> (m_antennaArrayList.begin ()->second));
-        }
-      else
-        {
-          /* Iterate over all the antenna arrays */
-          for (AntennaArrayListI iter = m_antennaArrayList.begin (); iter != m_antennaArrayList.end (); iter++)
-            {
-              DisposeAntennaConfig (StaticCast<ParametricAntennaConfig> (iter->second));
-            }
-        }
-    }
   Codebook::DoDispose ();
 }
 
@@ -269,6 +375,15 @@ CodebookParametric::SetCodebookFileName (std::string fileName)
   if (fileName != "")
     {
       m_fileName = fileName;
+      RepositoryKey key = std::make_tuple (m_fileName, m_mimoCodebook, m_totalAntennas, m_precalculatedPatterns);
+      Repository &repository = GetRepository ();
+      Repository::const_iterator it = repository.find (key);
+      if (m_shareCodebook && (it != repository.end ()))
+        {
+          NS_LOG_DEBUG ("Reuse the codebook loaded from " << m_fileName);
+          CopyCodebook (it->second);
+          return;
+        }
       if (m_mimoCodebook)
         {
           CreateMimoCodebook (m_fileName);
@@ -277,9 +392,34 @@ CodebookParametric::SetCodebookFileName (std::string fileName)
         {
           LoadCodebook (m_fileName);
         }
+      if (m_shareCodebook)
+        {
+          if (repository.empty ())
+            {
+              Simulator::ScheduleDestroy (&CodebookParametric::ClearRepository);
+            }
+          /* Keep a copy of the codebook before it is attached to a device and modified */
+          Ptr<CodebookParametric> original = CreateObject<CodebookParametric> ();
+          original->CopyCodebook (this);
+          repository[key] = original;
+        }
     }
 }
 
+CodebookParametric::Repository &
+CodebookParametric::GetRepository (void)
+{
+  static Repository repository;
+  return repository;
+}
+
+void
+CodebookParametric::ClearRepository (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  GetRepository ().clear ();
+}
+
 inline void
 CodebookParametric::NormalizeWeights (WeightsVector &weightsVector)
 {
@@ -314,6 +454,37 @@ CodebookParametric::ReadAntennaWeightsVector (std::ifstream &file, uint16_t elem
   return weights;
 }
 
+void
+CodebookParametric::InitializeArrayPatterns (Ptr<ParametricAntennaConfig> antennaConfig,
+                                             const std::vector<Ptr<ParametricPatternConfig> > &patterns)
+{
+  NS_LOG_FUNCTION (this << antennaConfig << patterns.size ());
+  m_patternVersion++;
+  if (!m_precalculatedPatterns)
+    {
+      for (std::vector<Ptr<ParametricPatternConfig> >::const_iterator it = patterns.begin (); it != patterns.end (); it++)
+        {
+          (*it)->arrayPattern = 0;
+          (*it)->lazyArrayPattern = Create<LazyArrayPattern> (antennaConfig->steeringVector,
+                                                              antennaConfig->singleElementDirectivity,
+                                                              (*it)->GetWeights ());
+        }
+      return;
+    }
+  std::vector<WeightsVector> weights;
+  for (std::vector<Ptr<ParametricPatternConfig> >::const_iterator it = patterns.begin (); it != patterns.end (); it++)
+    {
+      weights.push_back ((*it)->GetWeights ());
+    }
+  std::vector<ArrayPattern> arrayPatterns;
+  antennaConfig->CalculateArrayPatterns (weights, arrayPatterns, m_patternThreads);
+  for (size_t i = 0; i < patterns.size (); i++)
+    {
+      patterns[i]->arrayPattern = arrayPatterns[i];
+      patterns[i]->lazyArrayPattern = 0;
+    }
+}
+
 void
 CodebookParametric::LoadCodebook (std::string filename)
 {
@@ -390,11 +561,7 @@ CodebookParametric::LoadCodebook (std::string filename)
       antennaConfig->amplitudeQuantizationBits = std::stod (line);
 
       /* Allocate the directivity matrix. */
-      antennaConfig->singleElementDirectivity = new Directivity *[AZIMUTH_CARDINALITY];
-      for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
-        {
-          antennaConfig->singleElementDirectivity[m] = new Directivity[ELEVATION_CARDINALITY];
-        }
+      Ptr<DirectivityBuffer> elementDirectivity = Create<DirectivityBuffer> (PATTERN_CARDINALITY);
 
       /* Read the directivity of a single antenna element */
       for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
@@ -404,20 +571,13 @@ CodebookParametric::LoadCodebook (std::string filename)
           for (uint16_t n = 0; n < ELEVATION_CARDINALITY; n++)
             {
               std::getline (split, directivity, ',');
-              antennaConfig->singleElementDirectivity[m][n] = std::stod (directivity);
+              (*elementDirectivity)[GetPatternIndex (m, n)] = std::stod (directivity);
             }
         }
+      antennaConfig->singleElementDirectivity = elementDirectivity;
 
-      /* Allocate the steering vector 3D Matrix. */
-      antennaConfig->steeringVector = new Complex **[AZIMUTH_CARDINALITY];
-      for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
-        {
-          antennaConfig->steeringVector[m] = new Complex *[ELEVATION_CARDINALITY];
-          for (uint16_t n = 0; n < ELEVATION_CARDINALITY; n++)
-            {
-              antennaConfig->steeringVector[m][n] = new Complex[antennaConfig->numElements];
-            }
-        }
+      /* Allocate the steering vector 3D Matrix, one contiguous plane per antenna element. */
+      Ptr<ComplexBuffer> steeringVector = Create<ComplexBuffer> (antennaConfig->numElements * PATTERN_PLANE_STRIDE);
 
       /* Read the 3D steering vector of the antenna array */
       for (uint16_t l = 0; l < antennaConfig->numElements; l++)
@@ -430,19 +590,17 @@ CodebookParametric::LoadCodebook (std::string filename)
                 {
                   std::getline (split, amp, ',');
                   std::getline (split, phaseDelay, ',');
-                  antennaConfig->steeringVector[m][n][l] = std::polar (std::stod (amp), std::stod (phaseDelay));
+                  (*steeringVector)[l * PATTERN_PLANE_STRIDE + GetPatternIndex (m, n)] = std::polar (std::stod (amp), std::stod (phaseDelay));
                 }
             }
         }
+      antennaConfig->steeringVector = steeringVector;
 
       /* Read Quasi-omni antenna weights and calculate its directivity */
       Ptr<ParametricPatternConfig> quasiOmni = Create<ParametricPatternConfig> ();
       quasiOmni->SetWeights (ReadAntennaWeightsVector (file, antennaConfig->numElements));
-      if (m_precalculatedPatterns)
-        {
-          antennaConfig->CalculateArrayPattern (quasiOmni->GetWeights (), quasiOmni->arrayPattern);
-        }
       antennaConfig->SetQuasiOmniConfig (quasiOmni);
+      std::vector<Ptr<ParametricPatternConfig> > patterns (1, quasiOmni);
 
       /* Read the number of sectors within this antenna array */
       std::getline (file, line);
@@ -485,13 +643,13 @@ CodebookParametric::LoadCodebook (std::string filename)
 
           /* Read sector antenna weights vector and calculate its directivity */
           sectorConfig->SetWeights (ReadAntennaWeightsVector (file, antennaConfig->numElements));
-          if (m_precalculatedPatterns)
-            {
-              antennaConfig->CalculateArrayPattern (sectorConfig->GetWeights (), sectorConfig->arrayPattern);
-            }
           antennaConfig->sectorList[sectorID] = sectorConfig;
+          patterns.push_back (sectorConfig);
         }
 
+      /* Calculate the directivity of the quasi-omni pattern and the sectors together */
+      InitializeArrayPatterns (antennaConfig, patterns);
+
       if (bhiSectors.size () > 0)
         {
           m_bhiAntennaList[antennaID] = bhiSectors;
@@ -576,11 +734,7 @@ CodebookParametric::CreateMimoCodebook (std::string filename)
   antennaConfig->amplitudeQuantizationBits = std::stod (line);
 
   /* Allocate the directivity matrix. */
-  antennaConfig->singleElementDirectivity = new Directivity *[AZIMUTH_CARDINALITY];
-  for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
-    {
-      antennaConfig->singleElementDirectivity[m] = new Directivity[ELEVATION_CARDINALITY];
-    }
+  Ptr<DirectivityBuffer> elementDirectivity = Create<DirectivityBuffer> (PATTERN_CARDINALITY);
 
   /* Read the directivity of a single antenna element */
   for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
@@ -590,20 +744,13 @@ CodebookParametric::CreateMimoCodebook (std::string filename)
       for (uint16_t n = 0; n < ELEVATION_CARDINALITY; n++)
         {
           std::getline (split, directivity, ',');
-          antennaConfig->singleElementDirectivity[m][n] = std::stod (directivity);
+          (*elementDirectivity)[GetPatternIndex (m, n)] = std::stod (directivity);
         }
     }
+  antennaConfig->singleElementDirectivity = elementDirectivity;
 
-  /* Allocate the steering vector 3D Matrix. */
-  antennaConfig->steeringVector = new Complex **[AZIMUTH_CARDINALITY];
-  for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
-    {
-      antennaConfig->steeringVector[m] = new Complex *[ELEVATION_CARDINALITY];
-      for (uint16_t n = 0; n < ELEVATION_CARDINALITY; n++)
-        {
-          antennaConfig->steeringVector[m][n] = new Complex[antennaConfig->numElements];
-        }
-    }
+  /* Allocate the steering vector 3D Matrix, one contiguous plane per antenna element. */
+  Ptr<ComplexBuffer> steeringVector = Create<ComplexBuffer> (antennaConfig->numElements * PATTERN_PLANE_STRIDE);
 
   /* Read the 3D steering vector of the antenna array */
   for (uint16_t l = 0; l < antennaConfig->numElements; l++)
@@ -616,20 +763,17 @@ CodebookParametric::CreateMimoCodebook (std::string filename)
             {
               std::getline (split, amp, ',');
               std::getline (split, phaseDelay, ',');
-              antennaConfig->steeringVector[m][n][l] = std::polar (std::stod (amp), std::stod (phaseDelay));
+              (*steeringVector)[l * PATTERN_PLANE_STRIDE + GetPatternIndex (m, n)] = std::polar (std::stod (amp), std::stod (phaseDelay));
             }
         }
     }
+  antennaConfig->steeringVector = steeringVector;
 
   /* Read Quasi-omni antenna weights and calculate its directivity */
   Ptr<ParametricPatternConfig> quasiOmni = Create<ParametricPatternConfig> ();
   quasiOmni->SetWeights (ReadAntennaWeightsVector (file, antennaConfig->numElements));
-  if (m_precalculatedPatterns)
-    {
-      antennaConfig->CalculateArrayPattern (quasiOmni->GetWeights (), quasiOmni->arrayPattern);
-
-    }
   antennaConfig->SetQuasiOmniConfig (quasiOmni);
+  std::vector<Ptr<ParametricPatternConfig> > patterns (1, quasiOmni);
 
   /* Read the number of sectors within this antenna array */
   std::getline (file, line);
@@ -672,13 +816,13 @@ CodebookParametric::CreateMimoCodebook (std::string filename)
 
       /* Read sector antenna weights vector and calculate its directivity */
       sectorConfig->SetWeights (ReadAntennaWeightsVector (file, antennaConfig->numElements));
-      if (m_precalculatedPatterns)
-        {
-          antennaConfig->CalculateArrayPattern (sectorConfig->GetWeights (), sectorConfig->arrayPattern);
-        }
       antennaConfig->sectorList[sectorID] = sectorConfig;
+      patterns.push_back (sectorConfig);
     }
 
+  /* Calculate the directivity of the quasi-omni pattern and the sectors together */
+  InitializeArrayPatterns (antennaConfig, patterns);
+
   if (bhiSectors.size () > 0)
     {
       m_bhiAntennaList[antennaID] = bhiSectors;
@@ -708,6 +852,7 @@ CodebookParametric::CreateMimoCodebook (std::string filename)
       quasiPattern->m_weights = antennaConfig->GetQuasiOmniConfig ()->m_weights;
       quasiPattern->m_normalizationFactor = antennaConfig->GetQuasiOmniConfig ()->m_normalizationFactor;
       quasiPattern->arrayPattern = antennaConfig->GetQuasiOmniConfig ()->arrayPattern;
+      quasiPattern->lazyArrayPattern = antennaConfig->GetQuasiOmniConfig ()->lazyArrayPattern;
       dstAntennaConfig->SetQuasiOmniConfig (quasiPattern);
       for (SectorListI sectorIter = antennaConfig->sectorList.begin ();
            sectorIter != antennaConfig->sectorList.end (); sectorIter++)
@@ -720,6 +865,7 @@ CodebookParametric::CreateMimoCodebook (std::string filename)
           dstSectorConfig->m_weights = srcSectorConfig->m_weights;
           dstSectorConfig->m_normalizationFactor = srcSectorConfig->m_normalizationFactor;
           dstSectorConfig->arrayPattern = srcSectorConfig->arrayPattern;
+          dstSectorConfig->lazyArrayPattern = srcSectorConfig->lazyArrayPattern;
           dstAntennaConfig->sectorList[sectorIter->first] = dstSectorConfig;
         }
 
@@ -748,7 +894,6 @@ CodebookParametric::CreateMimoCodebook (std::string filename)
       rfChainConfig->ConnectPhasedAntennaArray (antennaID, dstAntennaConfig);
       dstAntennaConfig->rfChain = rfChainConfig;
     }
-  m_cloned = true;
   /* Close the file */
   file.close ();
 }
@@ -806,7 +951,7 @@ CodebookParametric::UpdateSectorWeights (AntennaID antennaID, SectorID sectorID,
         {
           Ptr<ParametricSectorConfig> sectorConfig = DynamicCast<ParametricSectorConfig> (sectorIter->second);
           sectorConfig->SetWeights (weightsVector);
-          antennaConfig->CalculateArrayPattern (weightsVector, sectorConfig->arrayPattern);
+          InitializeArrayPatterns (antennaConfig, std::vector<Ptr<ParametricPatternConfig> > (1, sectorConfig));
         }
       else
         {
@@ -819,42 +964,6 @@ CodebookParametric::UpdateSectorWeights (AntennaID antennaID, SectorID sectorID,
     }
 }
 
-void
-CodebookParametric::CalculateArrayPatterns (AntennaID antennaID, uint16_t azimuthAngle, uint16_t elevationAngle)
-{
-  NS_LOG_FUNCTION (this << uint16_t (antennaID << azimuthAngle << elevationAngle));
-  AntennaArrayListCI iter = m_antennaArrayList.find (antennaID);
-  Ptr<ParametricAntennaConfig> antennaConfig;
-  Ptr<ParametricSectorConfig> sectorConfig;
-  Ptr<Parametric_AWV_Config> awvConfig;
-  if (iter != m_antennaArrayList.end ())
-    {
-      antennaConfig = StaticCast<ParametricAntennaConfig> (iter->second);
-      for (SectorListI sectorIter = antennaConfig->sectorList.begin ();
-           sectorIter != antennaConfig->sectorList.end (); sectorIter++)
-        {
-          sectorConfig = DynamicCast<ParametricSectorConfig> (sectorIter->second);
-          sectorConfig->CalculateArrayPattern (antennaConfig, azimuthAngle, elevationAngle);
-          for (AWV_LIST_I awvIt = sectorConfig->awvList.begin ();  awvIt != sectorConfig->awvList.end (); awvIt++)
-            {
-              awvConfig = DynamicCast<Parametric_AWV_Config> (*awvIt);
-              awvConfig->CalculateArrayPattern (antennaConfig, azimuthAngle, elevationAngle);
-            }
-        }
-      antennaConfig->GetQuasiOmniConfig ()->CalculateArrayPattern (antennaConfig, azimuthAngle, elevationAngle);
-    }
-  else
-    {
-      NS_ABORT_MSG ("Cannot find the specified Antenna ID=" << static_cast<uint16_t> (antennaID));
-    }
-}
-
-bool
-CodebookParametric::ArrayPatternsPrecalculated (void) const
-{
-  return m_precalculatedPatterns;
-}
-
 void
 CodebookParametric::PrintWeights (WeightsVector weightsVector)
 {
@@ -949,7 +1058,7 @@ CodebookParametric::UpdateQuasiOmniWeights (AntennaID antennaID, WeightsVector &
     {
       Ptr<ParametricAntennaConfig> antennaConfig = StaticCast<ParametricAntennaConfig> (iter->second);
       antennaConfig->GetQuasiOmniConfig ()->SetWeights (weightsVector);
-      antennaConfig->CalculateArrayPattern (weightsVector, antennaConfig->GetQuasiOmniConfig ()->arrayPattern);
+      InitializeArrayPatterns (antennaConfig, std::vector<Ptr<ParametricPatternConfig> > (1, antennaConfig->GetQuasiOmniConfig ()));
     }
   else
     {
@@ -1023,7 +1132,7 @@ CodebookParametric::AppendBeamRefinementAwv (AntennaID antennaID, SectorID secto
           Ptr<ParametricSectorConfig> sectorConfig = DynamicCast<ParametricSectorConfig> (sectorIter->second);
           Ptr<Parametric_AWV_Config> awvConfig = Create<Parametric_AWV_Config> ();
           awvConfig->SetWeights (weightsVector);
-          antennaConfig->CalculateArrayPattern (sectorConfig->GetWeights (), awvConfig->arrayPattern);
+          InitializeArrayPatterns (antennaConfig, std::vector<Ptr<ParametricPatternConfig> > (1, awvConfig));
           sectorConfig->awvList.push_back (awvConfig);
           /* Change this */
           NS_ASSERT_MSG (sectorConfig->awvList.size () <= 64, "We can append upto 64 AWV per sector.");
@@ -1069,10 +1178,10 @@ CodebookParametric::AppendBeamRefinementAwv (AntennaID antennaID, SectorID secto
           /* Calculate the weights vector as the conjugate of the steering vector to the specified direction */
           for (uint16_t i = 0; i < antennaConfig->numElements; i++)
             {
-              weightsVector.push_back (std::conj (antennaConfig->steeringVector [azimuth][elevation][i]));
+              weightsVector.push_back (std::conj (antennaConfig->GetSteeringVector (i, azimuth, elevation)));
             }
           awvConfig->SetWeights (weightsVector);
-          antennaConfig->CalculateArrayPattern (awvConfig->GetWeights (), awvConfig->arrayPattern);
+          InitializeArrayPatterns (antennaConfig, std::vector<Ptr<ParametricPatternConfig> > (1, awvConfig));
           sectorConfig->awvList.push_back (awvConfig);
         }
       else
@@ -1207,7 +1316,14 @@ CodebookParametric::CopyCodebook (const Ptr<Codebook> codebook)
   Ptr<CodebookParametric> srcCodebook = DynamicCast<CodebookParametric> (codebook);
   Ptr<ParametricAntennaConfig> srcAntennaConfig;
   Ptr<ParametricSectorConfig> srcSectorConfig;
-  /* Copy antenna arrays */
+  Ptr<Parametric_AWV_Config> srcAwvConfig;
+  /* Copy RF chains */
+  for (RFChainListCI chainIt = srcCodebook->m_rfChainList.begin ();
+       chainIt != srcCodebook->m_rfChainList.end (); chainIt++)
+    {
+      m_rfChainList[chainIt->first] = Create<RFChain> ();
+    }
+  /* Copy antenna arrays, the steering vectors and the array patterns are shared with the source codebook */
   for (AntennaArrayListI arrayIt = srcCodebook->m_antennaArrayList.begin ();
        arrayIt != srcCodebook->m_antennaArrayList.end (); arrayIt++)
     {
@@ -1215,16 +1331,23 @@ CodebookParametric::CopyCodebook (const Ptr<Codebook> codebook)
       /* Copy antenna array config */
       srcAntennaConfig = StaticCast<ParametricAntennaConfig> (arrayIt->second);
       dstAntennaConfig->CopyAntennaArray (srcAntennaConfig);
-      /* Copy RF chain (Temporary) */
-      Ptr<RFChain> dstRfChain = Create<RFChain> ();
-      dstRfChain->ConnectPhasedAntennaArray (arrayIt->first, dstAntennaConfig);
-      dstAntennaConfig->rfChain = dstRfChain;
-      m_rfChainList[arrayIt->first] = dstRfChain;
+      /* Connect the antenna array to the RF chain with the same ID as in the source codebook */
+      for (RFChainListCI chainIt = srcCodebook->m_rfChainList.begin ();
+           chainIt != srcCodebook->m_rfChainList.end (); chainIt++)
+        {
+          if (chainIt->second == srcAntennaConfig->rfChain)
+            {
+              Ptr<RFChain> dstRfChain = m_rfChainList[chainIt->first];
+              dstRfChain->ConnectPhasedAntennaArray (arrayIt->first, dstAntennaConfig);
+              dstAntennaConfig->rfChain = dstRfChain;
+            }
+        }
       /* Copy quasi-omni config */
       Ptr<ParametricPatternConfig> quasiPattern = Create<ParametricPatternConfig> ();
       quasiPattern->m_weights = srcAntennaConfig->GetQuasiOmniConfig ()->m_weights;
       quasiPattern->m_normalizationFactor = srcAntennaConfig->GetQuasiOmniConfig ()->m_normalizationFactor;
       quasiPattern->arrayPattern = srcAntennaConfig->GetQuasiOmniConfig ()->arrayPattern;
+      quasiPattern->lazyArrayPattern = srcAntennaConfig->GetQuasiOmniConfig ()->lazyArrayPattern;
       dstAntennaConfig->SetQuasiOmniConfig (quasiPattern);
       for (SectorListI sectorIter = srcAntennaConfig->sectorList.begin ();
            sectorIter != srcAntennaConfig->sectorList.end (); sectorIter++)
@@ -1237,22 +1360,24 @@ CodebookParametric::CopyCodebook (const Ptr<Codebook> codebook)
           dstSectorConfig->sectorUsage = srcSectorConfig->sectorUsage;
           dstSectorConfig->m_weights = srcSectorConfig->m_weights;
           dstSectorConfig->arrayPattern = srcSectorConfig->arrayPattern;
+          dstSectorConfig->lazyArrayPattern = srcSectorConfig->lazyArrayPattern;
+          /* Copy the custom AWVs of the sector */
+          for (AWV_LIST_CI awvIt = srcSectorConfig->awvList.begin (); awvIt != srcSectorConfig->awvList.end (); awvIt++)
+            {
+              srcAwvConfig = DynamicCast<Parametric_AWV_Config> (*awvIt);
+              Ptr<Parametric_AWV_Config> dstAwvConfig = Create<Parametric_AWV_Config> ();
+              dstAwvConfig->m_weights = srcAwvConfig->m_weights;
+              dstAwvConfig->m_normalizationFactor = srcAwvConfig->m_normalizationFactor;
+              dstAwvConfig->arrayPattern = srcAwvConfig->arrayPattern;
+              dstAwvConfig->lazyArrayPattern = srcAwvConfig->lazyArrayPattern;
+              dstSectorConfig->awvList.push_back (dstAwvConfig);
+            }
           dstAntennaConfig->sectorList[sectorIter->first] = dstSectorConfig;
         }
       m_antennaArrayList[arrayIt->first] = dstAntennaConfig;
     }
-//  /* Copy RF chains */
-//  for (RFChainListI chainIt = srcCodebook->m_rfChainList.begin ();
-//       chainIt != srcCodebook->m_rfChainList.end (); chainIt++)
-//    {
-//      Ptr<RFChain> dstRfChain = Create<RFChain> ();
-//      dstRfChain
-//      m_rfChainList[chainIt->first] = dstRfChain;
-//    }
-//  Ptr<RFChain> srcRfChain;
   m_precalculatedPatterns = srcCodebook->m_precalculatedPatterns;
-  /* Set that we have cloned another codebook to avoid*/
-  m_cloned = true;
+  m_mimoCodebook = srcCodebook->m_mimoCodebook;
   /* Call parent class. */
   Codebook::CopyCodebook (srcCodebook);
 }
@@ -1264,7 +1389,7 @@ CodebookParametric::GetAntennaArrayPattern (Ptr<PatternConfig> config,
   Ptr<ParametricPatternConfig> parametricConfig = DynamicCast<ParametricPatternConfig> (config);
   if (m_precalculatedPatterns)
     {
-      return parametricConfig->GetArrayPattern ()[azimuthAngle][elevationAngle];
+      return parametricConfig->GetArrayPatternValue (azimuthAngle, elevationAngle);
     }
   else
     {
@@ -1277,7 +1402,7 @@ CodebookParametric::GetTxAntennaArrayPattern (uint16_t azimuthAngle, uint16_t el
 {
   if (m_precalculatedPatterns)
     {
-      return DynamicCast<ParametricPatternConfig> (GetTxPatternConfig ())->GetArrayPattern ()[azimuthAngle][elevationAngle];
+      return DynamicCast<ParametricPatternConfig> (GetTxPatternConfig ())->GetArrayPatternValue (azimuthAngle, elevationAngle);
     }
   else
     {
@@ -1290,7 +1415,7 @@ CodebookParametric::GetRxAntennaArrayPattern (uint16_t azimuthAngle, uint16_t el
 {
   if (m_precalculatedPatterns)
     {
-      return DynamicCast<ParametricPatternConfig> (GetRxPatternConfig ())->GetArrayPattern ()[azimuthAngle][elevationAngle];
+      return DynamicCast<ParametricPatternConfig> (GetRxPatternConfig ())->GetArrayPatternValue (azimuthAngle, elevationAngle);
     }
   else
     {
@@ -7,24 +7,126 @@
 #ifndef CODEBOOK_PARAMETRIC_H
 #define CODEBOOK_PARAMETRIC_H
 
+#include "ns3/core-config.h"
 #include "ns3/object.h"
+#include "ns3/simple-ref-count.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-mutex.h"
+#endif
 #include "codebook.h"
+#include <atomic>
 #include <complex>
 #include <iostream>
+#include <memory>
+#include <tuple>
+#include <type_traits>
 
 namespace ns3 {
 
+#define PATTERN_BUFFER_ALIGNMENT  64    //!< Alignment of the pattern buffers in bytes (one cache line).
+#define PATTERN_CARDINALITY       (AZIMUTH_CARDINALITY * ELEVATION_CARDINALITY)   //!< Number of angles in a pattern matrix.
+#define PATTERN_PLANE_STRIDE      65344 //!< PATTERN_CARDINALITY rounded up to a whole number of cache lines of complex values.
+#define PATTERN_BLOCK_SIZE        256   //!< Number of directions whose array patterns are accumulated together.
+
+/**
+ * \brief Contiguous buffer whose first element is aligned on a cache line.
+ *
+ * The buffers holding the steering vectors and the array patterns of a parametric codebook
+ * are reference counted, so that the codebooks cloned from the same file share them instead
+ * of copying them. Once filled, a buffer is only accessed through a pointer to const.
+ */
+template <typename T>
+class AlignedBuffer : public SimpleRefCount<AlignedBuffer<T> >
+{
+public:
+  /**
+   * Allocate a buffer of value-initialized elements.
+   * \param size The number of elements in the buffer.
+   */
+  explicit AlignedBuffer (size_t size);
+  ~AlignedBuffer ();
+  /**
+   * \return A pointer to the first element of the buffer.
+   */
+  T * GetData (void);
+  /**
+   * \return A constant pointer to the first element of the buffer.
+   */
+  const T * GetData (void) const;
+  /**
+   * \return The number of elements in the buffer.
+   */
+  size_t GetSize (void) const;
+  T & operator [] (size_t index);
+  const T & operator [] (size_t index) const;
+
+private:
+  static_assert (std::is_trivially_destructible<T>::value, "AlignedBuffer does not destroy its elements");
+
+  /* Buffers are shared through Ptr, never copied */
+  AlignedBuffer (const AlignedBuffer &);
+  AlignedBuffer & operator = (const AlignedBuffer &);
+
+  uint8_t *m_storage;   //!< The allocated memory, including the alignment padding.
+  T *m_data;            //!< The first aligned element.
+  size_t m_size;        //!< The number of elements.
+
+};
+
 typedef std::complex<float> Complex;                          //!< Typedef for a complex number.
 typedef std::vector<Complex> WeightsVector;                   //!< Typedef for an antenna weights vector.
 typedef WeightsVector::iterator WeightsVectorI;               //!< Typedef for an iterator for AWV.
 typedef WeightsVector::const_iterator WeightsVectorCI;        //!< Typedef for a constant iterator for AWV.
-typedef Complex** ArrayPattern;                               //!< Typedef for an phased antenna array pattern.
-typedef Directivity** DirectivityMatrix;                      //!< Typedef for phased antenna directivity matrix.
-typedef Complex*** SteeringVector;                            //!< Typedef for phased antenna steering vector.
-typedef std::pair<uint16_t, uint16_t> PatternAngles;          //!< Tyepdef for angles (Azimuth and Elevation) in degrees.
-typedef std::map<PatternAngles, Complex> ArrayPatternMap;     //!< Tyepdef for mapping between angles and array pattern value.
-typedef ArrayPatternMap::iterator ArrayPatternMapI;           //!< Typedef for array pattern map iterator.
-typedef ArrayPatternMap::const_iterator ArrayPatternMapCI;    //!< Typedef for array pattern map constant iterator.
+typedef AlignedBuffer<Complex> ComplexBuffer;                 //!< Typedef for a buffer of complex numbers.
+typedef AlignedBuffer<Directivity> DirectivityBuffer;         //!< Typedef for a buffer of directivity values.
+typedef Ptr<const ComplexBuffer> ArrayPattern;                //!< Typedef for an phased antenna array pattern (AZIMUTH x ELEVATION matrix).
+typedef Ptr<const DirectivityBuffer> DirectivityMatrix;       //!< Typedef for phased antenna directivity matrix (AZIMUTH x ELEVATION matrix).
+typedef Ptr<const ComplexBuffer> SteeringVector;              //!< Typedef for phased antenna steering vector (one plane per antenna element).
+
+/**
+ * \brief Array pattern whose values are calculated the first time their direction is requested.
+ *
+ * The values are stored in one row of ELEVATION_CARDINALITY slots per azimuth angle, allocated
+ * with the first value of the row, and a bitmap records which slots hold a value. Readers test
+ * the bit of a direction without locking, and the first reader of a direction calculates its
+ * value under a mutex and publishes it by setting the bit. Lookups never allocate memory once the
+ * value of a direction is known. The pattern only depends on its weights, so it can be shared by
+ * the codebooks cloned from the same file.
+ */
+class LazyArrayPattern : public SimpleRefCount<LazyArrayPattern>
+{
+public:
+  /**
+   * Create a lazily evaluated array pattern.
+   * \param steeringVector The steering vector of the antenna array.
+   * \param directivity The directivity of a single antenna element.
+   * \param weights The complex weights of the antenna elements.
+   */
+  LazyArrayPattern (SteeringVector steeringVector, DirectivityMatrix directivity, const WeightsVector &weights);
+  ~LazyArrayPattern ();
+  /**
+   * Get the array pattern value for particular angles, and calculate it if it is not known yet.
+   * \param azimuthAngle The azimuth angle in degrees.
+   * \param elevationAngle The elevation angle in degrees.
+   * \return The complex array pattern value.
+   */
+  Complex GetValue (uint16_t azimuthAngle, uint16_t elevationAngle);
+
+private:
+  /* Patterns are shared through Ptr, never copied */
+  LazyArrayPattern (const LazyArrayPattern &);
+  LazyArrayPattern & operator = (const LazyArrayPattern &);
+
+  SteeringVector m_steeringVector;                      //!< The steering vector of the antenna array.
+  DirectivityMatrix m_directivity;                      //!< The directivity of a single antenna element.
+  WeightsVector m_weights;                              //!< The complex weights of the antenna elements.
+  std::atomic<Complex *> m_rows[AZIMUTH_CARDINALITY];   //!< The calculated values of each azimuth angle.
+  std::atomic<uint64_t> m_known[(PATTERN_CARDINALITY + 63) / 64];   //!< Bitmap of the directions with a known value.
+#ifdef HAVE_PTHREAD_H
+  SystemMutex m_mutex;                                  //!< Mutex serializing the calculation of new values.
+#endif
+
+};
 
 struct ParametricPatternConfig;
 
@@ -34,6 +136,17 @@ struct ParametricPatternConfig;
  * \return The normalization factor assoicated with the antennas weights vector.
  */
 float CalculateNormalizationFactor (WeightsVector &weightsVector);
+/**
+ * Get the position of the value associated with particular angles within a pattern matrix.
+ * \param azimuthAngle The azimuth angle in degrees.
+ * \param elevationAngle The elevation angle in degrees.
+ * \return The index of the angles within a matrix of PATTERN_CARDINALITY values.
+ */
+inline size_t
+GetPatternIndex (uint16_t azimuthAngle, uint16_t elevationAngle)
+{
+  return static_cast<size_t> (azimuthAngle) * ELEVATION_CARDINALITY + elevationAngle;
+}
 
 /**
  * Parametric phased antenna array configuration.
@@ -46,6 +159,16 @@ public:
    * \param arrayPattern Pointer to the complex matrix of antenna array pattern.
    */
   void CalculateArrayPattern (WeightsVector weights, ArrayPattern &arrayPattern);
+  /**
+   * Calculate the complex patterns of several antenna weights vectors at once. The patterns are the
+   * product of the weights matrix by the steering matrix, which is computed one block of PATTERN_BLOCK_SIZE
+   * directions at a time so that each block of the steering matrix is loaded once for all the weights vectors.
+   * \param weights The complex weights of the antenna elements of each pattern.
+   * \param arrayPatterns The complex matrices of the antenna array patterns, in the order of the weights.
+   * \param threads The number of threads sharing the blocks of directions.
+   */
+  void CalculateArrayPatterns (const std::vector<WeightsVector> &weights, std::vector<ArrayPattern> &arrayPatterns,
+                               uint8_t threads);
   /**
    * Get the quasi-omni antenna array pattern associated with this array.
    * \param azimuthAngle
@@ -73,12 +196,33 @@ public:
    * \param srcAntennaConfig Pointer to the source antenna array config.
    */
   void CopyAntennaArray (Ptr<ParametricAntennaConfig> srcAntennaConfig);
+  /**
+   * Get the steering vector value of an antenna element for particular angles.
+   * \param element The index of the antenna element.
+   * \param azimuthAngle The azimuth angle in degrees.
+   * \param elevationAngle The elevation angle in degrees.
+   * \return The complex value of the steering vector.
+   */
+  Complex GetSteeringVector (uint16_t element, uint16_t azimuthAngle, uint16_t elevationAngle) const
+  {
+    return (*steeringVector)[element * PATTERN_PLANE_STRIDE + GetPatternIndex (azimuthAngle, elevationAngle)];
+  }
+  /**
+   * Get the directivity of a single antenna element for particular angles.
+   * \param azimuthAngle The azimuth angle in degrees.
+   * \param elevationAngle The elevation angle in degrees.
+   * \return The directivity of a single antenna element in linear scale.
+   */
+  Directivity GetSingleElementDirectivity (uint16_t azimuthAngle, uint16_t elevationAngle) const
+  {
+    return (*singleElementDirectivity)[GetPatternIndex (azimuthAngle, elevationAngle)];
+  }
 
 public:
   uint16_t numElements;                           //!<The number of the antenna elements in the phased antenna array.
-  SteeringVector steeringVector;                  //!< Steering matrix of MxNxL where L is the number of antenna elements
+  SteeringVector steeringVector;                  //!< Steering matrix of LxMxN where L is the number of antenna elements
                                                   // and M and N represent the azimuth and elevation angles of the incoming plane wave.
-
+                                                  // Each element owns a plane of PATTERN_PLANE_STRIDE values indexed by GetPatternIndex.
   DirectivityMatrix singleElementDirectivity;     //!< The directivity of a single antenna element in linear scale.
   uint8_t amplitudeQuantizationBits;              //!< Number of bits for quanitizing gain (amplitude) value.
 
@@ -114,25 +258,30 @@ public:
    */
   ArrayPattern GetArrayPattern (void) const;
   /**
-   * Get the array pattern value associated with this sector/awv for particular angles.
+   * Get the precalculated array pattern value associated with this sector/awv for particular angles.
    * \param azimuthAngle The azimuth angle in degrees.
    * \param elevationAngle The azimuth angle in degrees.
    * \return The array pattern of the antenna array for particular angles.
    */
-  Complex GetArrayPattern (uint16_t azimuthAngle, uint16_t elevationAngle);
+  Complex GetArrayPatternValue (uint16_t azimuthAngle, uint16_t elevationAngle) const
+  {
+    return (*arrayPattern)[GetPatternIndex (azimuthAngle, elevationAngle)];
+  }
   /**
-   * Calculate the complex array pattern value for particular angles.
+   * Get the array pattern value associated with this sector/awv for particular angles. The value is
+   * calculated on first use when the array pattern is not precalculated.
    * \param azimuthAngle The azimuth angle in degrees.
    * \param elevationAngle The azimuth angle in degrees.
+   * \return The array pattern of the antenna array for particular angles.
    */
-  void CalculateArrayPattern (Ptr<ParametricAntennaConfig> antennaConfig, uint16_t azimuthAngle, uint16_t elevationAngle);
+  Complex GetArrayPattern (uint16_t azimuthAngle, uint16_t elevationAngle) const;
 
 protected:
   friend class CodebookParametric;
   friend class ParametricAntennaConfig;
 
   ArrayPattern arrayPattern;                    //<! The complex phased antenna array pattern after applying the weights vector.
-  ArrayPatternMap arrayPatternMap;              //<! The complex values of the phased antenna array pattern.
+  Ptr<LazyArrayPattern> lazyArrayPattern;      //<! The phased antenna array pattern calculated on first use.
 
 private:
   WeightsVector m_weights;                      //!< Weights that define the directivity of the phased antenna array.
@@ -287,6 +436,11 @@ public:
    * \param codebook A pointer to the codebook that we want to copy its contents.
    */
   virtual void CopyCodebook (const Ptr<Codebook> codebook);
+  /**
+   * Release the codebooks kept in the repository of loaded codebook files. This is done
+   * automatically when the simulator is destroyed.
+   */
+  static void ClearRepository (void);
 
 protected:
   friend class QdPropagationEngine;
@@ -312,24 +466,11 @@ protected:
    * \return The array pattern of the receive phased antenna array.
    */
   Complex GetRxAntennaArrayPattern (uint16_t azimuthAngle, uint16_t elevationAngle);
-  /**
-   * Calculate array pattern for a particular pair of angles for all the sectors and their AWVs in the
-   * specified antenna array ID.
-   * \param antennaID The ID of the antenna array.
-   * \param azimuthAngle The azimuth angle in degrees after rounding it.
-   * \param elevationAngle The elevation angle in degrees after rounding it.
-   */
-  void CalculateArrayPatterns (AntennaID antennaID, uint16_t azimuthAngle, uint16_t elevationAngle);
-  /**
-   * \return True if the array patterns are precalculated, otherwise false.
-   */
-  bool ArrayPatternsPrecalculated (void) const;
 
 private:
   void DoDispose (void);
   void DoInitialize (void);
 
-  void DisposeAntennaConfig (Ptr<ParametricAntennaConfig> antennaConfig);
   /**
    * Print antenna weights vector or beamforming vector.
    * \param weightsVector The list of antenna weights to be printed.
@@ -352,14 +493,91 @@ private:
    * \param weightsVector The antennas weights vector to be normalized.
    */
   inline void NormalizeWeights (WeightsVector &weightsVector);
+  /**
+   * Initialize the array patterns of a list of pattern configurations of the same antenna array. The
+   * patterns are calculated together when PrecalculatePatterns is set, otherwise their values are
+   * calculated on first use.
+   * \param antennaConfig Pointer to the antenna array the patterns belong to.
+   * \param patterns The list of pattern configurations.
+   */
+  void InitializeArrayPatterns (Ptr<ParametricAntennaConfig> antennaConfig,
+                                const std::vector<Ptr<ParametricPatternConfig> > &patterns);
+
+  /**
+   * Key identifying the codebooks loaded from the same file with the same parameters
+   * (file name, MIMO codebook, total antennas and pattern precalculation).
+   */
+  typedef std::tuple<std::string, bool, uint8_t, bool> RepositoryKey;
+  typedef std::map<RepositoryKey, Ptr<CodebookParametric> > Repository;  //!< Typedef for the loaded codebook files.
+  /**
+   * Get the repository of the codebook files loaded by all the parametric codebooks. Each entry is a
+   * pristine copy of the codebook loaded from the file, which is not used by any device.
+   * \return A reference to the repository of loaded codebooks.
+   */
+  static Repository & GetRepository (void);
 
 private:
   bool m_precalculatedPatterns;   //!< Flag to indicate whether we have precalculated the array pattern.
-  bool m_cloned;                  //!< Flag to indicate if we have cloned this codebook.
+  uint8_t m_patternThreads;       //!< The number of threads precalculating the array patterns.
+  bool m_shareCodebook;           //!< Flag to indicate whether we reuse the codebooks loaded from the same file.
   bool m_mimoCodebook;            //!< Flag to indicate if we have MIMO codebook or typical legacy codebook.
 
 };
 
+/****** AlignedBuffer implementation ******/
+
+template <typename T>
+AlignedBuffer<T>::AlignedBuffer (size_t size)
+  : m_size (size)
+{
+  m_storage = new uint8_t[size * sizeof (T) + PATTERN_BUFFER_ALIGNMENT];
+  uintptr_t address = reinterpret_cast<uintptr_t> (m_storage);
+  address = (address + PATTERN_BUFFER_ALIGNMENT - 1) & ~static_cast<uintptr_t> (PATTERN_BUFFER_ALIGNMENT - 1);
+  m_data = reinterpret_cast<T *> (address);
+  std::uninitialized_fill_n (m_data, m_size, T ());
+}
+
+template <typename T>
+AlignedBuffer<T>::~AlignedBuffer ()
+{
+  delete[] m_storage;
+}
+
+template <typename T>
+T *
+AlignedBuffer<T>::GetData (void)
+{
+  return m_data;
+}
+
+template <typename T>
+const T *
+AlignedBuffer<T>::GetData (void) const
+{
+  return m_data;
+}
+
+template <typename T>
+size_t
+AlignedBuffer<T>::GetSize (void) const
+{
+  return m_size;
+}
+
+template <typename T>
+T &
+AlignedBuffer<T>::operator [] (size_t index)
+{
+  return m_data[index];
+}
+
+template <typename T>
+const T &
+AlignedBuffer<T>::operator [] (size_t index) const
+{
+  return m_data[index];
+}
+
 } // namespace ns3
 
 #endif /* CODEBOOK_PARAMETRIC_H */
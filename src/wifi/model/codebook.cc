@@ -41,6 +41,7 @@ Codebook::Codebook ()
     m_totalRxSectors (0),
     m_totalSectors (0),
     m_totalAntennas (0),
+    m_patternVersion (0),
     m_beaconRandomization (false),
     m_btiSectorOffset (0)
 {
@@ -634,11 +635,13 @@ void
 Codebook::CopyCodebook (const Ptr<Codebook> codebook)
 {
   NS_LOG_FUNCTION (this << codebook);
+  m_fileName = codebook->m_fileName;
   /* Sectors Data */
   m_txBeamformingSectors = codebook->m_txBeamformingSectors;
   m_rxBeamformingSectors = codebook->m_rxBeamformingSectors;
   m_totalTxSectors = codebook->m_totalTxSectors;
   m_totalRxSectors = codebook->m_totalRxSectors;
+  m_totalSectors = codebook->m_totalSectors;
   m_totalAntennas = codebook->m_totalAntennas;
   m_txCustomSectors = codebook->m_txCustomSectors;
   m_rxCustomSectors = codebook->m_rxCustomSectors;
@@ -763,6 +766,7 @@ Codebook::ChangeAntennaOrientation (AntennaID antennaID, double psi, double thet
       antennaConfig->orientation.psi = DegreesToRadians (psi);
       antennaConfig->orientation.theta = DegreesToRadians (theta);
       antennaConfig->orientation.phi = DegreesToRadians (phi);
+      m_patternVersion++;
     }
   else
     {
@@ -888,6 +892,12 @@ Codebook::IsQuasiOmniMode (void) const
   return m_activeRFChain->IsQuasiOmniMode ();
 }
 
+uint32_t
+Codebook::GetPatternVersion (void) const
+{
+  return m_patternVersion;
+}
+
 Orientation
 Codebook::GetOrientation (AntennaID antennaId)
 {
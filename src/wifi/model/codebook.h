@@ -295,6 +295,7 @@ protected:
   friend class WifiPhy;
   friend class SpectrumDmgWifiPhy;
   friend class QdPropagationEngine;
+  friend class DmgWifiChannel;
 
   virtual void DoDispose ();
   virtual void DoInitialize (void);
@@ -544,6 +545,13 @@ protected:
    * \return True if the antenna is in quasi-omni reception mode; otherwise false.
    */
   bool IsQuasiOmniMode (void) const;
+  /**
+   * Get the version of the antenna patterns. The version is incremented each time
+   * an existing pattern or antenna array configuration is modified in place, so
+   * that cached antenna gains computed from it can be invalidated.
+   * \return The current version of the antenna patterns.
+   */
+  uint32_t GetPatternVersion (void) const;
   /**
    * Get the 3d orientation of an antenna array.
    * \param antennaID The ID of the phased antenna array.
@@ -757,6 +765,7 @@ protected:
   uint8_t m_totalRxSectors;                   //!< The total number of receive sectors within the Codebook.
   uint8_t m_totalSectors;                     //!< The total number of sectors within the Codebook.
   uint8_t m_totalAntennas;                    //!< The total number of antennas within the Codebook.
+  uint32_t m_patternVersion;                  //!< Version of the antenna patterns, incremented on each in-place modification.
 
   /* BHI Access Period Variables */
   Antenna2SectorList m_bhiAntennaList;        //!< List of antenna arrays utilized during the BHI access period.
@@ -232,6 +232,7 @@ DmgApWifiMac::DmgApWifiMac ()
   m_initiateDynamicAllocation = false;
   m_monitoringChannel = false;
   m_beaconTrnFieldsDuration = NanoSeconds (0);
+  m_beaconTemplateValid = false;
   // Let the lower layers know that we are acting as an AP.
   SetTypeOfStation (DMG_AP);
 }
@@ -575,6 +576,7 @@ DmgApWifiMac::CleanupAllocations (void)
       if (!allocation.IsPseudoStatic () && iter->IsAllocationAnnounced ())
         {
           iter = m_allocationList.erase (iter);
+          m_beaconTemplateValid = false;
         }
       else
         {
@@ -654,6 +656,7 @@ DmgApWifiMac::AddAllocationPeriod (AllocationID id,
    * aDMGPPMinListeningTime if one or more of the source or destination DMG STAs participate in both SPs.
    */
   m_allocationList.push_back (field);
+  m_beaconTemplateValid = false;
 
   return (allocationStart + blockDuration);
 }
@@ -697,6 +700,7 @@ DmgApWifiMac::AllocateBeamformingServicePeriod (uint8_t sourceAid, uint8_t destA
 
   field.SetBfControl (bfField);
   m_allocationList.push_back (field);
+  m_beaconTemplateValid = false;
 
   return (allocationStart + allocationDuration + 1000); // 1000 = 1 us protection period
 }
@@ -856,6 +860,7 @@ DmgApWifiMac::CreateEdmgMuMimoGroups (void)
 {
   NS_LOG_FUNCTION (this);
   m_edmgGroupIdSetElement = Create<EDMGGroupIDSetElement> ();
+  m_beaconTemplateValid = false;
   uint8_t numGroups = 0;
   uint8_t groupId = 1;
   uint8_t groupSize = 0;
@@ -906,6 +911,7 @@ DmgApWifiMac::SendOneDMGBeacon (void)
   if (m_firstBeacon )
     {
       m_firstBeacon = false;
+      m_beaconTemplateValid = false;
     }
   else
     {
@@ -923,7 +929,12 @@ DmgApWifiMac::SendOneDMGBeacon (void)
       hdr.SetPacketType (TRN_R);
     }
 
-  ExtDMGBeacon beacon;
+  /* Only the timestamp and the sector sweep field differ between the DMG Beacons of the same BTI */
+  if (!m_beaconTemplateValid)
+    {
+      UpdateBeaconTemplate ();
+    }
+  ExtDMGBeacon beacon = m_beaconTemplate;
 
   /* Timestamp */
   /**
@@ -942,6 +953,20 @@ DmgApWifiMac::SendOneDMGBeacon (void)
   ssw.SetDMGAntennaID (m_codebook->GetActiveAntennaID ());
   beacon.SetSSWField (ssw);
 
+  Time btiRemaining = GetBTIRemainingTime ();
+  NS_LOG_DEBUG ("BTI Remaining Time=" << btiRemaining);
+  NS_ASSERT_MSG (btiRemaining.IsStrictlyPositive (), "Remaining BTI Period should not be negative.");
+
+  /* The DMG beacon has it's own special queue, so we load it in there */
+  m_beaconTxop->TransmitDmgBeacon (beacon, hdr, btiRemaining - m_dmgBeaconDurationUs);
+}
+
+void
+DmgApWifiMac::UpdateBeaconTemplate (void)
+{
+  NS_LOG_FUNCTION (this);
+  ExtDMGBeacon beacon;
+
   /* Beacon Interval */
   beacon.SetBeaconIntervalUs (m_beaconInterval.GetMicroSeconds ());
 
@@ -1065,12 +1090,8 @@ DmgApWifiMac::SendOneDMGBeacon (void)
       beacon.AddWifiInformationElement (m_edmgGroupIdSetElement);
     }
 
-  Time btiRemaining = GetBTIRemainingTime ();
-  NS_LOG_DEBUG ("BTI Remaining Time=" << btiRemaining);
-  NS_ASSERT_MSG (btiRemaining.IsStrictlyPositive (), "Remaining BTI Period should not be negative.");
-
-  /* The DMG beacon has it's own special queue, so we load it in there */
-  m_beaconTxop->TransmitDmgBeacon (beacon, hdr, btiRemaining - m_dmgBeaconDurationUs);
+  m_beaconTemplate = beacon;
+  m_beaconTemplateValid = true;
 }
 
 void
@@ -2768,6 +2789,7 @@ DmgApWifiMac::Receive (Ptr<WifiMacQueueItem> mpdu)
                                 (allocation.GetDestinationAid () == info.GetDestinationAid ()))
                               {
                                 iter = m_allocationList.erase (iter);
+                                m_beaconTemplateValid = false;
                                 break;
                               }
                             else
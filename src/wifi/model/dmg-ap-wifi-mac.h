@@ -502,6 +502,11 @@ private:
    * Send One DMG Beacon frame with the provided arguments.
    */
   void SendOneDMGBeacon (void);
+  /**
+   * Build the DMG Beacon template shared by all the DMG Beacons of the current BTI. The template
+   * holds every field and information element except the timestamp and the sector sweep field.
+   */
+  void UpdateBeaconTemplate (void);
   /**
    * Get Beacon Header Interval Duration
    * \return The duration of BHI.
@@ -554,6 +559,8 @@ private:
   std::vector<Mac48Address> m_beamformingInDTI; //!< List of the stations to train in DTI because beamforming is not completed in BTI.
   uint8_t m_trnUnitsBeacon;             //!< Number of TRN-R units appended  to EDMG Beacons.
   bool m_firstBeacon;                   //!< Flag to identify the first DMG Beacon that we send.
+  ExtDMGBeacon m_beaconTemplate;        //!< DMG Beacon template reused across the sectors of the current BTI.
+  bool m_beaconTemplateValid;           //!< Flag to indicate whether the DMG Beacon template is up to date.
   bool m_groupTraining;                 //!< Flag to indicate whether we beamforming training using TRN fields in Beacons is enabled or not.
 
   /** DMG PCP/AP Clustering **/
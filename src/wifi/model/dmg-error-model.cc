@@ -27,6 +27,7 @@
 #include "wifi-utils.h"
 #include "wifi-tx-vector.h"
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 
@@ -36,54 +37,8 @@ NS_LOG_COMPONENT_DEFINE ("DmgErrorModel");
 
 NS_OBJECT_ENSURE_REGISTERED (DmgErrorModel);
 
-void
-SNR2BER_STRUCT::DetermineSnrOffset (void)
-{
-  NS_LOG_FUNCTION (this);
-  double snr = snrMin;
-  double toleranceForAssumingZero = 0.0001;
-  for (int i = 0; i < numSnrDecPlaces; i++)
-    {
-      toleranceForAssumingZero /= 10;
-    }
-  if (snrMin < 0)
-    {
-      for (; snr <= 2 * snrSpacing; snr += snrSpacing)
-        {
-          if (snr >= 0)
-            {
-              snrOffset = snr;
-              break;
-            }
-        }
-      if (std::abs (snr) <= toleranceForAssumingZero) //if less than tolerance assume 0
-        {
-          snrOffset = 0;
-        }
-    }
-  else if (snrMin > 0)
-    {
-      for (; snr >= -2 * snrSpacing; snr -= snrSpacing)
-        {
-          if (snr <= 0)
-            {
-              snrOffset = snr;
-              break;
-            }
-        }
-      if (std::abs (snr) <= toleranceForAssumingZero) //if less than tolerance assume 0
-        {
-          snrOffset = 0;
-        }
-    }
-  else //if m_snrMin == 0
-    {
-      snrOffset = 0;
-    }
-}
-
 double
-SNR2BER_STRUCT::GetBitErrorRate (double snr)
+SNR2BER_STRUCT::GetBitErrorRate (double snr) const
 {
   NS_LOG_FUNCTION (this << snr);
   if (snr <= snrMin)
@@ -99,100 +54,15 @@ SNR2BER_STRUCT::GetBitErrorRate (double snr)
   else
     {
       NS_LOG_DEBUG ("Performing linear interpolation on snr for bit error rate lookup.");
-      InterpolParams iParams;
-      double ber; //bit error rate to return
-      iParams = FindDatapointBounds (snr);
-      ber = InterpolateAndRetrieveData (snr, iParams.snrLoBound, iParams.snrHiBound);
+      double position = (snr - snrMin) / snrSpacing;
+      size_t index = std::min (static_cast<size_t> (position), bitErrorRateTable.size () - 2);
+      double fraction = position - index;
+      double ber = ((1 - fraction) * bitErrorRateTable[index]) + (fraction * bitErrorRateTable[index + 1]);
+      NS_LOG_DEBUG ("BER1=" << bitErrorRateTable[index] << ", BER2=" << bitErrorRateTable[index + 1] << ", BER=" << ber);
       return ber;
     }
 }
 
-int
-SNR2BER_STRUCT::RoundDoubleToInt (double val)
-{
-  NS_LOG_FUNCTION (this << val);
-  if (val > 0.0)
-    {
-      return val + 0.5;
-    }
-  else
-    {
-      return val - 0.5;
-    }
-}
-
-double
-SNR2BER_STRUCT::RoundToNearestDataMidpoint (double value)
-{
-  NS_LOG_FUNCTION (this << value);
-  double newOffset = (snrSpacing / 2) + snrOffset;
-  return (RoundDoubleToInt ((value - newOffset) / snrSpacing) * snrSpacing) + newOffset;
-}
-
-SNR2BER_STRUCT::InterpolParams
-SNR2BER_STRUCT::FindDatapointBounds (double snr)
-{
-  InterpolParams iParams;
-  double snrRatio = snr / snrSpacing;
-  double snrLoBoundNoOffset = floor (snrRatio) * snrSpacing;
-  double snrHiBoundNoOffset = ceil (snrRatio) * snrSpacing;
-  double nearestMidSnrPoint = RoundToNearestDataMidpoint (snr);
-  if (snr > nearestMidSnrPoint)
-    {
-      iParams.snrLoBound = snrLoBoundNoOffset - snrOffset;
-      iParams.snrHiBound = snrHiBoundNoOffset - snrOffset;
-    }
-  else
-    {
-      iParams.snrLoBound = snrLoBoundNoOffset + snrOffset;
-      iParams.snrHiBound = snrHiBoundNoOffset + snrOffset;
-    }
-  return iParams;
-}
-
-int
-SNR2BER_STRUCT::DoubleToHashKeyInt (double val)
-{
-  NS_LOG_FUNCTION (this << val);
-  for (uint8_t i = 0; i < numSnrDecPlaces; i++)
-    {
-      val = val * 10;
-    }
-  return (int)(round (val));
-}
-
-double
-SNR2BER_STRUCT::InterpolateAndRetrieveData (double xd, double x1d, double x2d)
-{
-  NS_LOG_FUNCTION (this << xd << x1d << x2d);
-  int x1 = DoubleToHashKeyInt (x1d);
-  int x2 = DoubleToHashKeyInt (x2d);
-  std::map<int, double>::iterator elemIter;
-  double fp; //retrieved value after any interpolation
-  double fq1, fq2;
-  elemIter = bitErrorRateTable.find (x1);
-  if (elemIter == bitErrorRateTable.end ())
-    {
-      NS_FATAL_ERROR ("No bit error rate data stored for snr key = " << x1);
-    }
-  else
-    {
-      fq1 = (*elemIter).second;
-    }
-  elemIter = bitErrorRateTable.find (x2);
-  if (elemIter == bitErrorRateTable.end ())
-    {
-      NS_FATAL_ERROR ("No bit error rate data stored for snr key = " << x2);
-    }
-  else
-    {
-      fq2 = (*elemIter).second;
-    }
-  fp = (((x2d - xd) / (x2d - x1d)) * fq1) + (((xd - x1d) / (x2d - x1d)) * fq2);
-  NS_LOG_DEBUG ("BER1=" << fq1 << ", BER2=" << fq2 << ", BER=" << fp);
-  return fp;
-}
-
 TypeId
 DmgErrorModel::GetTypeId (void)
 {
@@ -210,7 +80,6 @@ DmgErrorModel::GetTypeId (void)
 
 DmgErrorModel::DmgErrorModel ()
   : m_errorRateTablesLoaded (false),
-    m_numSnrDecPlaces (0),
     m_snrSpacing (1),
     m_numMCSs (0)
 {
@@ -234,9 +103,11 @@ DmgErrorModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double
     mode.GetModulationClass () == WIFI_MOD_CLASS_EDMG_OFDM,
     "Expecting 802.11ad DMG CTRL, SC or OFDM modulation or 802.11ay EDMG CTRL, SC or OFDM modulation");
 
-  Ptr<SNR2BER_STRUCT> snr2ber = m_snr2berList.find (mode.GetMcsValue ())->second;
-  double ber = snr2ber->GetBitErrorRate (RatioToDb (snr));
-  double psr = pow (1 - ber, nbits); /* Compute Packet Success Rate (PSR) from BER */
+  NS_ASSERT_MSG ((mode.GetMcsValue () < m_snr2berList.size ()) && (m_snr2berList[mode.GetMcsValue ()] != 0),
+                 "No SNR to BER table for MCS=" << uint16_t (mode.GetMcsValue ()));
+  double ber = m_snr2berList[mode.GetMcsValue ()]->GetBitErrorRate (RatioToDb (snr));
+  /* Compute Packet Success Rate (PSR) from BER, i.e., (1 - BER)^nbits, in the log domain */
+  double psr = (ber < 1) ? std::exp (nbits * std::log1p (-ber)) : ((nbits == 0) ? 1 : 0);
   NS_LOG_DEBUG ("PSR=" << psr);
 
   return psr;
@@ -258,7 +129,6 @@ DmgErrorModel::LoadErrorRateTables (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT_MSG (!m_errorRateTablesLoaded, "bit error rate table has already been loaded");
-  std::pair<std::map<int, double>::iterator, bool> ret;
 
   std::ifstream file;
   file.open (m_fileName, std::ifstream::in);
@@ -267,15 +137,13 @@ DmgErrorModel::LoadErrorRateTables (void)
 
   MCS_IDX idx;
   std::string value;
-  int snrInt;  /* SNR converted to an integer to use as hash key */
 
   /* Read the number of MCSs in the file */
   std::getline (file, line);
   m_numMCSs = std::stod (line);
 
-  /* Read number of SNR Decimal Places */
+  /* Skip the number of SNR decimal places, the SNR datapoints are located on the uniform grid instead */
   std::getline (file, line);
-  m_numSnrDecPlaces = std::stoul (line);
 
   /* Read SNR Spacing value */
   std::getline (file, line);
@@ -286,8 +154,7 @@ DmgErrorModel::LoadErrorRateTables (void)
       std::vector<double> snrs, bers;
       Ptr<SNR2BER_STRUCT> snr2berStruct = Create<SNR2BER_STRUCT> ();
 
-      /* Assign the global SNR Spacing and number of decimal places */
-      snr2berStruct->numSnrDecPlaces = m_numSnrDecPlaces;
+      /* Assign the global SNR Spacing */
       snr2berStruct->snrSpacing = m_snrSpacing;
 
       /* Read MCS Index */
@@ -332,19 +199,20 @@ DmgErrorModel::LoadErrorRateTables (void)
           bers.push_back (std::stod (value));
         }
 
-      /* Build SNR to BER Table using integer SNR values */
+      /* Build SNR to BER Table, the SNR datapoints must be uniformly spaced from the minimum SNR */
+      double tolerance = m_snrSpacing / 100;
       for (uint16_t n = 0; n < snr2berStruct->numDataPoints; n++)
         {
-          snrInt = snr2berStruct->DoubleToHashKeyInt (snrs[n]);
-          /* Add datapoint to hash map */
-          ret = snr2berStruct->bitErrorRateTable.insert (std::pair<int, double> (snrInt, bers[n]));
-          NS_ASSERT_MSG (ret.second, "element with SNR hash of " << snrInt <<
-                                     " already exists in bit error table hash map with value of " << ret.first->second);
+          NS_ABORT_MSG_IF (std::abs (snrs[n] - (snr2berStruct->snrMin + n * m_snrSpacing)) > tolerance,
+                           "SNR datapoint " << snrs[n] << " of MCS=" << uint16_t (idx) << " is not on the uniform SNR grid");
         }
+      NS_ABORT_MSG_IF (snr2berStruct->numDataPoints < 2, "At least two SNR datapoints are needed for MCS=" << uint16_t (idx));
+      snr2berStruct->bitErrorRateTable = bers;
 
-      /* Determine SNR Offset from 0 */
-      snr2berStruct->DetermineSnrOffset ();
-
+      if (idx >= m_snr2berList.size ())
+        {
+          m_snr2berList.resize (idx + 1);
+        }
       m_snr2berList[idx] = snr2berStruct;
     }
 
@@ -25,16 +25,16 @@
 
 #include "error-rate-model.h"
 #include "wifi-mode.h"
-#include <map>
+#include <vector>
 
 namespace ns3 {
 
+/**
+ * SNR to BER table of a single MCS. The BER datapoints are stored in a flat array
+ * uniformly spaced in SNR starting from the minimum SNR, so that looking up the
+ * BER of any SNR is a direct index computation followed by a linear interpolation.
+ */
 struct SNR2BER_STRUCT : public SimpleRefCount<SNR2BER_STRUCT> {
-  /**
-   * Determines offset from zero of SNR datapoints in lookup table.
-   */
-  void DetermineSnrOffset (void);
-
   /**
    * Returns the bit error rate (BER) for the given signal to noise ratio (SNR) input
    * from the lookup table. If the input SNR lie in between SNR datapoints, linear
@@ -43,74 +43,22 @@ struct SNR2BER_STRUCT : public SimpleRefCount<SNR2BER_STRUCT> {
    * the BER corresponding to the minimum/maximum SNR datapoint is returned.
    * \param snr the signal to noise ratio (in dB) corresponding to the BER to
    * look up
-   * \return the retrieved frame sync error rate corresponding to the input SNR
-   */
-  double GetBitErrorRate (double snr);
-
-  /**
-   * A struct containing the lower and upper SNR datapoint bounds used in linear
-   * interpolation.
-   */
-  struct InterpolParams
-  {
-    double snrLoBound;
-    double snrHiBound;
-  };
-
-  /**
-   * Rounds input value to the nearest data midpoint with given data spacing
-   * and offset from zero. For example, an SNR dataset with SNR datapoints at
-   * {-5, -2, 1, 4, 7, 10,...} has offset=1 and dataSpacing=3. The midpoints
-   * between these numbers would be {-3.5, -0.5, 2.5, 5.5, 8.5,...}. So for
-   * value=3.5 for this dataset, this method will return 2.5.
-   * \param value the input value to round
-   * \return the nearest data midpoint value
-   */
-  double RoundToNearestDataMidpoint (double value);
-  /**
-   * Finds upper and lower SNR datapoint bounds around input SNR. If input SNR
-   * is at upper or lower bound, both bounds are set equal to input SNR.
-   * \param snr the input SNR (in dB).
-   * \return the struct containing the upper and lower SNR datapoint bounds
-   */
-  InterpolParams FindDatapointBounds (double snr);
-  /**
-   * Rounds input double value to the nearest integer.
-   * \param val the double value to round.
-   * \return the input value rounded to the nearest integer.
-   */
-  int RoundDoubleToInt (double val);
-  /**
-   * Converts double value to integer key used for lookup table indexing.
-   * \param val the double value to convert to integer key.
-   * \return the integer key corresponding to the input double value.
-   */
-  int DoubleToHashKeyInt (double val);
-  /**
-   * Retrieves BER value from lookup table based on input SNR and its SNR
-   * datapoint bounds, performing linear interpolation.
-   * \param xd the SNR (in dB) corresponding to the SER to look up
-   * \param x1d the lower SNR datapoint bound (in dB) of xd.
-   * \param x2d the upper SNR datapoint bound (in dB) of xd.
-   * \return the retrieved SER
+   * \return the retrieved bit error rate corresponding to the input SNR
    */
-  double InterpolateAndRetrieveData (double xd, double x1d, double x2d);
+  double GetBitErrorRate (double snr) const;
 
   uint16_t numDataPoints;                    //!< The number of SNR to BER datapoints.
   double snrMin;                             //!< Minimum (in dB) SNR datapoint value.
   double snrMax;                             //!< Maximum (in dB) SNR datapoint value.
   double berMin;                             //!< BER datapoint value corresponding to the minimum SNR value.
   double berMax;                             //!< BER datapoint value corresponding to the maximum SNR value.
-  std::map<int, double> bitErrorRateTable;   //!< Stores frame synchronization error rate values indexed by integer SNR key.
-  double snrOffset;                          //!< Offset from zero (in dB) of SNR datapoints.
-  uint8_t numSnrDecPlaces;                   //!< Number of decimal places in SNR datapoints.
   double snrSpacing;                         //!< Spacing (in dB) between SNR datapoints.
+  std::vector<double> bitErrorRateTable;     //!< BER datapoints, the i-th one corresponding to snrMin + i * snrSpacing.
 
 };
 
 typedef uint8_t MCS_IDX;                                        //!< Typedef for MCS index.
-typedef std::map<MCS_IDX, Ptr<SNR2BER_STRUCT> > SNR2BER_LIST;   //!< Typedef for mapping MCS to its SNR to BER tables.
-typedef SNR2BER_LIST::iterator SNR2BER_LIST_I;                  //!< Typedef for iterator over SNR to BER tables.
+typedef std::vector<Ptr<SNR2BER_STRUCT> > SNR2BER_LIST;         //!< Typedef for the SNR to BER tables indexed by MCS.
 
 /**
  * \ingroup wifi
@@ -166,7 +114,6 @@ private:
 private:
   std::string m_fileName;           //!< The name of the file describing the transmit and receive patterns.
   bool m_errorRateTablesLoaded;     //!< Indicates if frames BER tables has been loaded.
-  uint8_t m_numSnrDecPlaces;        //!< Number of decimal places in SNR datapoints.
   double m_snrSpacing;              //!< Spacing (in dB) between SNR datapoints.
   uint8_t m_numMCSs;                //!< The first line determines the number of MCSs within the lookup table.
   SNR2BER_LIST m_snr2berList;       //!< List of SNR to BER Tables.
@@ -21,6 +21,8 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/propagation-loss-model.h"
@@ -53,6 +55,32 @@ DmgWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&DmgWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("RestrictTrnFieldFanOut",
+                   "If true, the AGC, TRN-CE and TRN subfields of a TRN field are delivered only to the receivers "
+                   "currently synchronized to the sender of the PPDU carrying the field, instead of being broadcast "
+                   "to every PHY on the channel. Other receivers drop these subfields anyway, so beam refinement results "
+                   "are unchanged while a TRN field no longer generates one event per subfield per PHY. "
+                   "The PHY activity of the subfields is not recorded for the skipped receivers, and a stochastic "
+                   "propagation loss model or blockage callback is not sampled for them.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&DmgWifiChannel::m_restrictTrnFanOut),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxLossDb",
+                   "The maximum propagation loss in dB for which signals are delivered to a receiver. "
+                   "Receivers beyond this loss are culled before computing antenna gains or scheduling "
+                   "any reception event, and the decision is cached per link until either end moves. "
+                   "The cached decision assumes a deterministic propagation loss model. "
+                   "A value of 1e9 or above disables culling.",
+                   DoubleValue (1.0e9),
+                   MakeDoubleAccessor (&DmgWifiChannel::m_maxLossDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("CacheAntennaGains",
+                   "If true, the transmit and receive antenna gains of each link are cached per active "
+                   "pattern and reused until either end of the link moves or its codebook modifies "
+                   "its patterns, instead of being recomputed for every PPDU and TRN subfield.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&DmgWifiChannel::m_cacheAntennaGains),
+                   MakeBooleanChecker ())
     /* New trace sources for DMG PLCP */
     .AddTraceSource ("PhyActivityTracker",
                      "Trace source for transmitting/receiving PLCP field (PHY Tracker).",
@@ -65,7 +93,9 @@ DmgWifiChannel::GetTypeId (void)
 DmgWifiChannel::DmgWifiChannel ()
   : m_blockage (0),
     m_packetDropper (0),
-    m_experimentalMode (false)
+    m_experimentalMode (false),
+    m_restrictTrnFanOut (true),
+    m_cacheAntennaGains (true)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -74,6 +104,8 @@ DmgWifiChannel::~DmgWifiChannel ()
 {
   NS_LOG_FUNCTION (this);
   m_phyList.clear ();
+  m_reachableSets.clear ();
+  m_linkGains.clear ();
 }
 
 void
@@ -164,13 +196,131 @@ DmgWifiChannel::UpdateSignalStrengthValue (void)
   Simulator::Schedule (m_updateFrequency, &DmgWifiChannel::UpdateSignalStrengthValue, this);
 }
 
+bool
+DmgWifiChannel::IsReachable (Ptr<DmgWifiPhy> sender, uint32_t i, double txPowerDbm) const
+{
+  if (m_experimentalMode || (m_maxLossDb >= 1.0e9))
+    {
+      return true;
+    }
+
+  ReachableSet &reachableSet = m_reachableSets[sender];
+  if (reachableSet.size () != m_phyList.size ())
+    {
+      LinkReachability link;
+      link.evaluated = false;
+      reachableSet.resize (m_phyList.size (), link);
+    }
+
+  Ptr<MobilityModel> senderMobility = sender->GetMobility ();
+  Ptr<MobilityModel> receiverMobility = m_phyList[i]->GetMobility ();
+  Vector senderPosition = senderMobility->GetPosition ();
+  Vector receiverPosition = receiverMobility->GetPosition ();
+  LinkReachability &link = reachableSet[i];
+  if (!link.evaluated
+      || (link.senderPosition != senderPosition)
+      || (link.receiverPosition != receiverPosition))
+    {
+      double lossDb = txPowerDbm - m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+      link.senderPosition = senderPosition;
+      link.receiverPosition = receiverPosition;
+      link.evaluated = true;
+      link.reachable = (lossDb <= m_maxLossDb);
+      NS_LOG_DEBUG ("Link to PHY " << i << " re-evaluated: loss=" << lossDb << "dB, reachable=" << link.reachable);
+    }
+  return link.reachable;
+}
+
+DmgWifiChannel::LinkGains &
+DmgWifiChannel::GetLinkGains (Ptr<DmgWifiPhy> sender, uint32_t i) const
+{
+  LinkGainsList &gainsList = m_linkGains[sender];
+  if (gainsList.size () != m_phyList.size ())
+    {
+      LinkGains gains;
+      gains.evaluated = false;
+      gainsList.resize (m_phyList.size (), gains);
+    }
+
+  Vector senderPosition = sender->GetMobility ()->GetPosition ();
+  Vector receiverPosition = m_phyList[i]->GetMobility ()->GetPosition ();
+  uint32_t senderVersion = sender->GetCodebook ()->GetPatternVersion ();
+  uint32_t receiverVersion = m_phyList[i]->GetCodebook ()->GetPatternVersion ();
+  LinkGains &gains = gainsList[i];
+  if (!gains.evaluated
+      || (gains.senderPosition != senderPosition)
+      || (gains.receiverPosition != receiverPosition)
+      || (gains.senderVersion != senderVersion)
+      || (gains.receiverVersion != receiverVersion))
+    {
+      gains.senderPosition = senderPosition;
+      gains.receiverPosition = receiverPosition;
+      gains.senderVersion = senderVersion;
+      gains.receiverVersion = receiverVersion;
+      gains.evaluated = true;
+      gains.txGains.clear ();
+      gains.rxGains.clear ();
+    }
+  return gains;
+}
+
+double
+DmgWifiChannel::GetTxAntennaGainDbi (Ptr<DmgWifiPhy> sender, uint32_t i) const
+{
+  Ptr<Codebook> codebook = sender->GetCodebook ();
+  Vector senderPosition = sender->GetMobility ()->GetPosition ();
+  Vector receiverPosition = m_phyList[i]->GetMobility ()->GetPosition ();
+  if (!m_cacheAntennaGains)
+    {
+      return codebook->GetTxGainDbi (CalculateAzimuthAngle (senderPosition, receiverPosition));
+    }
+
+  LinkGains &gains = GetLinkGains (sender, i);
+  AntennaGainKey key = std::make_tuple (codebook->GetTxPatternConfig (), codebook->GetAntennaArrayConfig (), false);
+  AntennaGainMap::const_iterator it = gains.txGains.find (key);
+  if (it != gains.txGains.end ())
+    {
+      return it->second;
+    }
+  double gain = codebook->GetTxGainDbi (CalculateAzimuthAngle (senderPosition, receiverPosition));
+  gains.txGains[key] = gain;
+  return gain;
+}
+
+double
+DmgWifiChannel::GetRxAntennaGainDbi (Ptr<DmgWifiPhy> sender, uint32_t i) const
+{
+  Ptr<Codebook> codebook = m_phyList[i]->GetCodebook ();
+  Vector senderPosition = sender->GetMobility ()->GetPosition ();
+  Vector receiverPosition = m_phyList[i]->GetMobility ()->GetPosition ();
+  if (!m_cacheAntennaGains)
+    {
+      return codebook->GetRxGainDbi (CalculateAzimuthAngle (receiverPosition, senderPosition));
+    }
+
+  LinkGains &gains = GetLinkGains (sender, i);
+  AntennaGainKey key = std::make_tuple (codebook->GetRxPatternConfig (), codebook->GetAntennaArrayConfig (),
+                                        codebook->IsQuasiOmniMode ());
+  AntennaGainMap::const_iterator it = gains.rxGains.find (key);
+  if (it != gains.rxGains.end ())
+    {
+      return it->second;
+    }
+  double gain = codebook->GetRxGainDbi (CalculateAzimuthAngle (receiverPosition, senderPosition));
+  gains.rxGains[key] = gain;
+  return gain;
+}
+
 void
 DmgWifiChannel::Send (Ptr<DmgWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const
 {
   NS_LOG_FUNCTION (this << sender << ppdu << txPowerDbm);
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+  /* The PPDU is not modified by the receivers, so a single copy is shared by all of them */
+  Ptr<WifiPpdu> copy = Copy (ppdu);
+  uint32_t j = 0; /* Phy ID */
+  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
     {
       if (sender != (*i))
         {
@@ -180,6 +330,12 @@ DmgWifiChannel::Send (Ptr<DmgWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double t
               continue;
             }
 
+          /* Receiver Culling */
+          if (!IsReachable (sender, j, txPowerDbm))
+            {
+              continue;
+            }
+
           /* Packet Dropper */
           if ((m_packetDropper != 0) && ((m_srcWifiPhy == sender) && (m_dstWifiPhy == (*i))))
             {
@@ -189,19 +345,13 @@ DmgWifiChannel::Send (Ptr<DmgWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double t
                 }
             }
 
-          Vector sender_pos = senderMobility->GetPosition ();
-          Ptr<Codebook> senderCodebook = sender->GetCodebook ();
           Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
           Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
           double rxPowerDbm;
-          double azimuthTx = CalculateAzimuthAngle (sender_pos, receiverMobility->GetPosition ());
-          double azimuthRx = CalculateAzimuthAngle (receiverMobility->GetPosition (), sender_pos);
-          double gtx = senderCodebook->GetTxGainDbi (azimuthTx);        // Sender's antenna gain in dBi.
-          double grx = (*i)->GetCodebook ()->GetRxGainDbi (azimuthRx);  // Receiver's antenna gain in dBi.
-
-          NS_LOG_DEBUG ("POWER: azimuthTx=" << azimuthTx
-                        << ", azimuthRx=" << azimuthRx
-                        << ", txPowerDbm=" << txPowerDbm
+          double gtx = GetTxAntennaGainDbi (sender, j);  // Sender's antenna gain in dBi.
+          double grx = GetRxAntennaGainDbi (sender, j);  // Receiver's antenna gain in dBi.
+
+          NS_LOG_DEBUG ("POWER: txPowerDbm=" << txPowerDbm
                         << ", RxPower=" << m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility)
                         << ", Gtx=" << gtx
                         << ", Grx=" << grx);
@@ -226,7 +376,6 @@ DmgWifiChannel::Send (Ptr<DmgWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double t
 
           NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
                         "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<WifiPpdu> copy = Copy (ppdu);
           Ptr<NetDevice> dstNetDevice = (*i)->GetDevice ();
           uint32_t dstNode;
           if (dstNetDevice == 0)
@@ -281,11 +430,21 @@ DmgWifiChannel::SendAgcSubfield (Ptr<DmgWifiPhy> sender, double txPowerDbm, Wifi
               continue;
             }
 
+          /* Only the receivers synchronized to the sender process the TRN field */
+          if (m_restrictTrnFanOut && ((*i)->GetCurrentSender () != txVector.GetSender ()))
+            {
+              continue;
+            }
+
+          /* Receiver Culling */
+          if (!IsReachable (sender, j, txPowerDbm))
+            {
+              continue;
+            }
+
           receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
           delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          Ptr<Codebook> senderCodebook = sender->GetCodebook ();
-          double azimuthTx = CalculateAzimuthAngle (senderMobility->GetPosition (), receiverMobility->GetPosition ());
-          double gtx = senderCodebook->GetTxGainDbi (azimuthTx);
+          double gtx = GetTxAntennaGainDbi (sender, j);
 
           Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
           uint32_t dstNode;	/* Destination node (Receiver) */
@@ -326,11 +485,21 @@ DmgWifiChannel::SendTrnCeSubfield (Ptr<DmgWifiPhy> sender, double txPowerDbm, Wi
               continue;
             }
 
+          /* Only the receivers synchronized to the sender process the TRN field */
+          if (m_restrictTrnFanOut && ((*i)->GetCurrentSender () != txVector.GetSender ()))
+            {
+              continue;
+            }
+
+          /* Receiver Culling */
+          if (!IsReachable (sender, j, txPowerDbm))
+            {
+              continue;
+            }
+
           receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
           delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          Ptr<Codebook> senderCodebook = sender->GetCodebook ();
-          double azimuthTx = CalculateAzimuthAngle (senderMobility->GetPosition (), receiverMobility->GetPosition ());
-          double gtx = senderCodebook->GetTxGainDbi (azimuthTx);
+          double gtx = GetTxAntennaGainDbi (sender, j);
 
           Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
           uint32_t dstNode;	/* Destination node (Receiver) */
@@ -371,11 +540,21 @@ DmgWifiChannel::SendTrnSubfield (Ptr<DmgWifiPhy> sender, double txPowerDbm, Wifi
               continue;
             }
 
+          /* Only the receivers synchronized to the sender process the TRN field */
+          if (m_restrictTrnFanOut && ((*i)->GetCurrentSender () != txVector.GetSender ()))
+            {
+              continue;
+            }
+
+          /* Receiver Culling */
+          if (!IsReachable (sender, j, txPowerDbm))
+            {
+              continue;
+            }
+
           receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
           delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          Ptr<Codebook> senderCodebook = sender->GetCodebook ();
-          double azimuthTx = CalculateAzimuthAngle (senderMobility->GetPosition (), receiverMobility->GetPosition ());
-          double gtx = senderCodebook->GetTxGainDbi (azimuthTx);
+          double gtx = GetTxAntennaGainDbi (sender, j);
 
           Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
           uint32_t dstNode;	/* Destination node (Receiver) */
@@ -432,15 +611,14 @@ DmgWifiChannel::ReceiveSubfield (uint32_t i, Ptr<DmgWifiPhy> sender, WifiTxVecto
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   Ptr<MobilityModel> receiverMobility = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT ((senderMobility != 0) && (receiverMobility != 0));
-  double azimuthRx = CalculateAzimuthAngle (receiverMobility->GetPosition (), senderMobility->GetPosition ());
+  double grx = GetRxAntennaGainDbi (sender, i);
   double rxPowerDbm;
 
-  NS_LOG_DEBUG ("POWER: Gtx=" << txAntennaGainDbi
-                << ", Grx=" << m_phyList[i]->GetCodebook ()->GetRxGainDbi (azimuthRx));
+  NS_LOG_DEBUG ("POWER: Gtx=" << txAntennaGainDbi << ", Grx=" << grx);
 
   rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility) +
-               txAntennaGainDbi +                                           // Sender's antenna gain.
-               m_phyList[i]->GetCodebook ()->GetRxGainDbi (azimuthRx);      // Receiver's antenna gain.
+               txAntennaGainDbi +   // Sender's antenna gain.
+               grx;                 // Receiver's antenna gain.
 
   /* PHY Activity Monitor */
   RecordPhyActivity (sender->GetDevice ()->GetNode ()->GetId (),
@@ -22,7 +22,10 @@
 #define DMG_WIFI_CHANNEL_H
 
 #include "ns3/channel.h"
+#include "ns3/vector.h"
 #include "dmg-wifi-phy.h"
+#include <map>
+#include <tuple>
 
 namespace ns3 {
 
@@ -161,6 +164,80 @@ private:
    */
   typedef std::vector<Ptr<DmgWifiPhy> > PhyList;
 
+  /**
+   * Cached reachability of a single link, valid as long as both ends stay
+   * at the positions at which it was evaluated.
+   */
+  struct LinkReachability
+  {
+    Vector senderPosition;    //!< Position of the sender when the link was evaluated.
+    Vector receiverPosition;  //!< Position of the receiver when the link was evaluated.
+    bool evaluated;           //!< Flag to indicate whether the entry holds a valid decision.
+    bool reachable;           //!< Flag to indicate whether the path loss is below MaxLossDb.
+  };
+  typedef std::vector<LinkReachability> ReachableSet;
+  typedef std::map<Ptr<const DmgWifiPhy>, ReachableSet> ReachableSetMap;
+
+  /**
+   * Check whether the receiver at the given index can be reached by the sender,
+   * i.e., whether the propagation loss between them does not exceed MaxLossDb.
+   * The decision is cached per sender and re-evaluated only when either end of
+   * the link has moved, so out-of-range receivers never generate any event.
+   * \param sender the PHY object from which the signal is originating.
+   * \param i index of the receiving DmgWifiPhy in the PHY list.
+   * \param txPowerDbm the TX power of the signal in dBm.
+   * \return True if the receiver must be delivered the signal, otherwise false.
+   */
+  bool IsReachable (Ptr<DmgWifiPhy> sender, uint32_t i, double txPowerDbm) const;
+
+  /**
+   * Key of a cached antenna gain: the active pattern, the active antenna array
+   * and the quasi-omni reception flag of the codebook the gain was computed with.
+   */
+  typedef std::tuple<Ptr<const PatternConfig>, Ptr<const PhasedAntennaArrayConfig>, bool> AntennaGainKey;
+  typedef std::map<AntennaGainKey, double> AntennaGainMap;
+
+  /**
+   * Cached antenna gains of a single link, valid as long as both ends stay at
+   * the positions at which they were evaluated and their codebooks are unchanged.
+   */
+  struct LinkGains
+  {
+    Vector senderPosition;      //!< Position of the sender when the gains were evaluated.
+    Vector receiverPosition;    //!< Position of the receiver when the gains were evaluated.
+    uint32_t senderVersion;     //!< Pattern version of the sender codebook.
+    uint32_t receiverVersion;   //!< Pattern version of the receiver codebook.
+    bool evaluated;             //!< Flag to indicate whether the entry holds valid gains.
+    AntennaGainMap txGains;     //!< Transmit antenna gains of the sender towards the receiver in dBi.
+    AntennaGainMap rxGains;     //!< Receive antenna gains of the receiver towards the sender in dBi.
+  };
+  typedef std::vector<LinkGains> LinkGainsList;
+  typedef std::map<Ptr<const DmgWifiPhy>, LinkGainsList> LinkGainsMap;
+
+  /**
+   * Get the cached antenna gains of the link between the sender and the receiver
+   * at the given index. The gains are flushed if either end of the link has moved
+   * or if any of the two codebooks has modified its patterns.
+   * \param sender the PHY object from which the signal is originating.
+   * \param i index of the receiving DmgWifiPhy in the PHY list.
+   * \return A reference to the cached gains of the link.
+   */
+  LinkGains &GetLinkGains (Ptr<DmgWifiPhy> sender, uint32_t i) const;
+  /**
+   * Get the gain of the active transmit pattern of the sender towards the receiver.
+   * \param sender the PHY object from which the signal is originating.
+   * \param i index of the receiving DmgWifiPhy in the PHY list.
+   * \return The transmit antenna gain in dBi.
+   */
+  double GetTxAntennaGainDbi (Ptr<DmgWifiPhy> sender, uint32_t i) const;
+  /**
+   * Get the gain of the active receive pattern of the receiver towards the sender.
+   * \param sender the PHY object from which the signal is originating.
+   * \param i index of the receiving DmgWifiPhy in the PHY list.
+   * \return The receive antenna gain in dBi.
+   */
+  double GetRxAntennaGainDbi (Ptr<DmgWifiPhy> sender, uint32_t i) const;
+
   /**
    * This method is scheduled by Send for each associated DmgWifiPhy.
    * The method PPDU calls the corresponding DmgWifiPhy that the first
@@ -221,6 +298,11 @@ private:
   uint64_t m_currentSignalStrengthIndex;           //!< Index of the current signal strength.
   bool m_experimentalMode;                         //!< Experimental mode used for injecting signal strength values.
   Time m_updateFrequency;                          //!< Update frequency of the results.
+  bool m_restrictTrnFanOut;                        //!< Flag to indicate whether TRN subfields are delivered only to the synchronized receivers.
+  double m_maxLossDb;                              //!< Maximum propagation loss for which signals are delivered.
+  mutable ReachableSetMap m_reachableSets;         //!< Per-sender cache of the reachable receivers.
+  bool m_cacheAntennaGains;                        //!< Flag to indicate whether antenna gains are cached per link.
+  mutable LinkGainsMap m_linkGains;                //!< Per-sender cache of the antenna gains towards each receiver.
 
   /**
    * TracedCallback signature for reporting PHY activities.
@@ -22,9 +22,11 @@
 #include "wifi-mac-queue.h"
 #include "wifi-utils.h"
 #include "bft-id-tag.h"
+#include "mimo-assignment-solver.h"
 
 #include <algorithm>
 #include <queue>
+#include <set>
 
 namespace ns3 {
 
@@ -1741,20 +1743,14 @@ DmgWifiMac::MapTxSnr (Mac48Address address, AntennaID RxAntennaID, AntennaID TxA
   NS_LOG_FUNCTION (this << address << uint16_t (RxAntennaID)<< uint16_t (TxAntennaID) << uint16_t (sectorID) << RatioToDb (snr));
   STATION_SNR_PAIR_MAP_I it = m_stationSnrMap.find (address);
   ANTENNA_CONFIGURATION_COMBINATION config = std::make_tuple (RxAntennaID, TxAntennaID, sectorID);
-  if (it != m_stationSnrMap.end ())
-    {
-      SNR_PAIR *snrPair = (SNR_PAIR *) (&it->second);
-      SNR_MAP_TX *snrMap = (SNR_MAP_TX *) (&snrPair->first);
-      (*snrMap)[config] = snr;
-    }
-  else
+  if (it == m_stationSnrMap.end ())
     {
-      SNR_MAP_TX snrTx;
-      SNR_MAP_RX snrRx;
-      snrTx[config] = snr;
-      SNR_PAIR snrPair = std::make_pair (snrTx, snrRx);
-      m_stationSnrMap[address] = snrPair;
+      it = m_stationSnrMap.insert (std::make_pair (address, SNR_PAIR ())).first;
+      m_stationBestSnrMap[address] = BEST_SNR_PAIR ();
     }
+  SNR_MAP_TX &snrMap = it->second.first;
+  snrMap[config] = snr;
+  UpdateBestSnr (m_stationBestSnrMap[address].first, snrMap, config, snr);
 }
 
 void
@@ -1769,19 +1765,47 @@ DmgWifiMac::MapRxSnr (Mac48Address address, AntennaID antennaID, SectorID sector
   NS_LOG_FUNCTION (this << address << uint16_t (antennaID) << uint16_t (sectorID) << snr);
   STATION_SNR_PAIR_MAP::iterator it = m_stationSnrMap.find (address);
   ANTENNA_CONFIGURATION_COMBINATION config = std::make_tuple (m_codebook->GetActiveAntennaID (), antennaID, sectorID);
-  if (it != m_stationSnrMap.end ())
+  if (it == m_stationSnrMap.end ())
     {
-      SNR_PAIR *snrPair = (SNR_PAIR *) (&it->second);
-      SNR_MAP_RX *snrMap = (SNR_MAP_RX *) (&snrPair->second);
-      (*snrMap)[config] = snr;
+      it = m_stationSnrMap.insert (std::make_pair (address, SNR_PAIR ())).first;
+      m_stationBestSnrMap[address] = BEST_SNR_PAIR ();
     }
-  else
+  SNR_MAP_RX &snrMap = it->second.second;
+  snrMap[config] = snr;
+  UpdateBestSnr (m_stationBestSnrMap[address].second, snrMap, config, snr);
+}
+
+void
+DmgWifiMac::UpdateBestSnr (BestSnrEntry &best, const SNR_MAP &snrMap,
+                           const ANTENNA_CONFIGURATION_COMBINATION &config, SNR snr)
+{
+  if (!best.isValid)
     {
-      SNR_MAP_TX snrTx;
-      SNR_MAP_RX snrRx;
-      snrRx[config] = snr;
-      SNR_PAIR snrPair = std::make_pair (snrTx, snrRx);
-      m_stationSnrMap[address] = snrPair;
+      /* The first SNR value recorded in the table is also the best one */
+      if (snrMap.size () == 1)
+        {
+          best.config = config;
+          best.snr = snr;
+          best.isValid = true;
+        }
+    }
+  else if (config == best.config)
+    {
+      if (snr >= best.snr)
+        {
+          best.snr = snr;
+        }
+      else
+        {
+          /* Another antenna configuration might be the best now, search for it on the next query */
+          best.isValid = false;
+        }
+    }
+  /* Among equal SNR values, the lowest antenna configuration is the best one */
+  else if ((best.snr < snr) || ((best.snr == snr) && (config < best.config)))
+    {
+      best.config = config;
+      best.snr = snr;
     }
 }
 
@@ -3275,29 +3299,31 @@ DmgWifiMac::SendSuMimoBfFeedbackFrame (void)
 void
 DmgWifiMac::FindAllValidCombinations (uint16_t offset, uint16_t nStreams, MIMO_FEEDBACK_SORTED_MAPS &txRxCombinations,
                                       std::vector<std::vector<uint16_t> > &validCombinations, std::vector<uint16_t> &currentCombination,
-                                      std::vector<uint16_t> indexes)
+                                      const std::vector<uint16_t> &indexes)
 {
   if (nStreams == 0)
     {
-      /* We have a combination of nStreams Tx-Rx pairs, check if it's a valid one - no two Tx-Rx pairs in the combination should have
-    * the same Tx or Rx Id since we want to establish independent streams. */
+      /* Conflicting Tx-Rx pairs are pruned while the combination is built, so any complete combination is a valid one. */
+      validCombinations.push_back (currentCombination);
+      return;
+    }
+  for (uint16_t i = offset; i <= indexes.size() - nStreams; ++i)
+    {
+      /* No two Tx-Rx pairs in the combination should have the same Tx or Rx Id since we want to establish independent streams,
+       * so skip this Tx-Rx pair (and every combination that would contain it) if it conflicts with the pairs chosen so far. */
+      const MIMO_FEEDBACK_CONFIGURATION &candidatePair = txRxCombinations.at (indexes[i]).begin ()->second;
       bool foundValidCombination = true;
-      for (auto it = currentCombination.begin (); it != currentCombination.end () - 1; it++)
+      for (auto it = currentCombination.begin (); it != currentCombination.end (); it++)
         {
-          for (auto insideIt = it + 1; insideIt != currentCombination.end (); insideIt++)
+          const MIMO_FEEDBACK_CONFIGURATION &chosenPair = txRxCombinations.at (*it).begin ()->second;
+          if ((std::get<0> (chosenPair) == std::get<0> (candidatePair)) || (std::get<1> (chosenPair) == std::get<1> (candidatePair)))
             {
-              if ((std::get<0> (txRxCombinations.at (*it).begin ()->second) == std::get<0> (txRxCombinations.at (*insideIt).begin ()->second))
-                  || (std::get<1> (txRxCombinations.at (*it).begin ()->second) == std::get<1> (txRxCombinations.at (*insideIt).begin ()->second)))
-                foundValidCombination = false;
+              foundValidCombination = false;
+              break;
             }
         }
-      /* If we have a valid combination, add it to the list of valid combinations. */
-      if (foundValidCombination)
-        validCombinations.push_back (currentCombination);
-      return;
-    }
-  for (uint16_t i = offset; i <= indexes.size() - nStreams; ++i)
-    {
+      if (!foundValidCombination)
+        continue;
       currentCombination.push_back(indexes[i]);
       FindAllValidCombinations (i+1, nStreams-1, txRxCombinations, validCombinations, currentCombination, indexes);
       currentCombination.pop_back ();
@@ -3307,35 +3333,34 @@ DmgWifiMac::FindAllValidCombinations (uint16_t offset, uint16_t nStreams, MIMO_F
 void
 DmgWifiMac::FindAllValidTxRxPairs (uint16_t offset, uint8_t nStreams, uint8_t nRx,
                                    std::vector<std::vector<uint16_t>> &validTxRxPairs, std::vector<uint16_t> &currentCombination,
-                                   std::vector<uint16_t> indexes)
+                                   const std::vector<uint16_t> &indexes)
 {
   if (nStreams == 0)
     {
-      bool foundValidCombination = true;
-      /* If we have nStreams streams established check if this is a valid combination */
-      for (auto it = currentCombination.begin (); it != currentCombination.end () - 1; it++)
-        {
-          for (auto insideIt = it + 1; insideIt != currentCombination.end (); insideIt++)
-            {
-              /* Match the indexes to the correct Tx antenna Id and Rx antenna Id */
-              uint8_t txId1 = std::floor (*it / static_cast<double> (nRx));
-              uint8_t txId2 = std::floor (*insideIt / static_cast<double> (nRx));
-              uint8_t rxId1 = (*it % nRx);
-              uint8_t rxId2 = (*insideIt % nRx);
-              /* If the Tx or Rx Antenna Id is the same this is not a valid combination */
-              if (txId1 == txId2 || rxId1 == rxId2)
-                foundValidCombination = false;
-            }
-        }
-      if (foundValidCombination)
-        {
-          validTxRxPairs.push_back (currentCombination);
-        }
+      /* Conflicting Tx-Rx pairs are pruned while the combination is built, so any complete combination is a valid one. */
+      validTxRxPairs.push_back (currentCombination);
       return;
     }
   /* Continue iterating until we have found all possible combinations */
   for (uint16_t i = offset; i <= indexes.size() - nStreams; ++i)
     {
+      /* Match the index to the correct Tx antenna Id and Rx antenna Id */
+      uint8_t txId1 = std::floor (indexes[i] / static_cast<double> (nRx));
+      uint8_t rxId1 = (indexes[i] % nRx);
+      bool foundValidCombination = true;
+      for (auto it = currentCombination.begin (); it != currentCombination.end (); it++)
+        {
+          uint8_t txId2 = std::floor (*it / static_cast<double> (nRx));
+          uint8_t rxId2 = (*it % nRx);
+          /* If the Tx or Rx Antenna Id is the same this is not a valid combination */
+          if (txId1 == txId2 || rxId1 == rxId2)
+            {
+              foundValidCombination = false;
+              break;
+            }
+        }
+      if (!foundValidCombination)
+        continue;
       /* Continue adding streams until we reach nStreams */
       currentCombination.push_back (indexes[i]);
       FindAllValidTxRxPairs(i+1, nStreams-1, nRx, validTxRxPairs, currentCombination, indexes);
@@ -3390,54 +3415,55 @@ DmgWifiMac::FindKBestCombinations (uint16_t k, uint8_t numberOfStreams, uint8_t
     indexes.push_back (i);
   FindAllValidCombinations (0, numberOfStreams, combinations, validCombinations,currentCombination, indexes);
 
-  /* Check all valid combinations */
-  MIMO_CANDIDATE_MAP candidateCombinations;
-  for (auto combination : validCombinations)
+  /* Give random access to the sorted feedback of each Tx-Rx pair. */
+  std::vector<std::vector<MIMO_FEEDBACK_SORTED_MAP_I> > sortedLists (combinations.size ());
+  for (uint16_t i = 0; i < combinations.size (); i++)
     {
-      /* Set an iterator at the start of the feedback map that has the Tx-Rx combination for each stream specified in the combination
-       * (+ save the index in the vector combinations) */
-      std::vector<std::pair<uint16_t, MIMO_FEEDBACK_SORTED_MAP_I>> combinationIterators;
-      for (auto index : combination)
-        {
-          MIMO_FEEDBACK_SORTED_MAP_I it = combinations.at (index).begin ();
-          combinationIterators.push_back (std::make_pair (index, it));
-        }
-      /* Find all possible combinations of antenna configurations (now looking at the Tx Antenna ID, Rx Antenna ID and the Tx Sector ID)
-       * for the given Tx-Rx combinations and calculate the joint SNR by adding up the feedback SNRs of the individual configurations */
-      bool endOfFinalList = false;
-      // while we haven't checked all possible combinations
-      while (!endOfFinalList)
-        {
-          MIMO_FEEDBACK_COMBINATION combination;
-          SNR combinationSnr = 0;
-          bool endOfList = true;
-          // for each member of the combination
-          for (auto && iterator : combinationIterators)
-            {
-              // add the antenna configuration to the list
-              combination.push_back (iterator.second->second);
-              // add the SNR to the joint SNR
-              combinationSnr += iterator.second->first;
-              // If the previous combination reached the end of the feedback configurations - move to the next configuration of the list.
-              if (endOfList)
-                {
-                  iterator.second++;
-                  // If we reach the end of the feedback configurations - reset the iterator at the start and signal to the next combination that it needs to move forward.
-                  if (iterator.second == combinations.at (iterator.first).end ())
-                    {
-                      iterator.second = combinations.at (iterator.first).begin ();
-                      endOfList = true;
-                    }
-                  // otherwise signal to the next combination to stay at the same feedback configuration
-                  else
-                    endOfList = false;
-                }
-            }
-          // If the last combination reached the end of the feedback configuration list, we have finished checking all possible combinations.
-          if (endOfList)
-            endOfFinalList = true;
-          candidateCombinations.insert (std::make_pair (combinationSnr, combination));
-        }
+      for (MIMO_FEEDBACK_SORTED_MAP_I it = combinations.at (i).begin (); it != combinations.at (i).end (); it++)
+        sortedLists.at (i).push_back (it);
+    }
+
+  /* Rather than evaluating the joint SNR of every possible antenna configuration of every valid combination, we
+   * enumerate the candidates lazily in descending order of joint SNR using a best-first search. Each candidate is
+   * identified by the valid combination it belongs to and by the position it takes in the sorted list of each of
+   * its Tx-Rx pairs. Since the lists are sorted in descending order, moving one position further down a list never
+   * increases the joint SNR, so the best candidate not yet visited is always on the heap. Every candidate has
+   * a single parent (the one obtained by moving its first non-zero position back by one), which means that
+   * candidates are pushed at most once and no visited set is required. Ties are resolved in the same order
+   * in which an exhaustive enumeration of the candidates would have produced them. */
+  struct MimoCandidate
+  {
+    SNR snr;
+    uint16_t combinationIdx;
+    std::vector<uint16_t> positions;
+  };
+  struct MimoCandidateCompare
+  {
+    bool operator() (const MimoCandidate &a, const MimoCandidate &b) const
+    {
+      if (a.snr != b.snr)
+        return a.snr < b.snr;
+      if (a.combinationIdx != b.combinationIdx)
+        return a.combinationIdx > b.combinationIdx;
+      return std::lexicographical_compare (b.positions.rbegin (), b.positions.rend (),
+                                           a.positions.rbegin (), a.positions.rend ());
+    }
+  };
+  auto getJointSnr = [&] (uint16_t combinationIdx, const std::vector<uint16_t> &positions)
+    {
+      SNR jointSnr = 0;
+      for (uint16_t i = 0; i < positions.size (); i++)
+        jointSnr += sortedLists.at (validCombinations.at (combinationIdx).at (i)).at (positions.at (i))->first;
+      return jointSnr;
+    };
+  std::priority_queue<MimoCandidate, std::vector<MimoCandidate>, MimoCandidateCompare> candidates;
+  for (uint16_t i = 0; i < validCombinations.size (); i++)
+    {
+      MimoCandidate candidate;
+      candidate.combinationIdx = i;
+      candidate.positions.assign (validCombinations.at (i).size (), 0);
+      candidate.snr = getJointSnr (i, candidate.positions);
+      candidates.push (candidate);
     }
 
   /* Create a list of the K best Tx combinations according to the highest joint SNR,
@@ -3447,24 +3473,39 @@ DmgWifiMac::FindKBestCombinations (uint16_t k, uint8_t numberOfStreams, uint8_t
    * ID pairs (since we are generating only a list of Tx sectors to train) so here we remove any
    * combinations which all have the same Tx Antenna ID, Sector ID pairs but different Rx IDs */
   MIMO_ANTENNA_COMBINATIONS_LIST kBestCombinations;
-  for (MIMO_CANDIDATE_MAP_I it = candidateCombinations.begin (); it != candidateCombinations.end (); it++)
+  std::set<MIMO_ANTENNA_COMBINATION> addedCombinations;
+  while (!candidates.empty () && kBestCombinations.size () < k)
     {
+      MimoCandidate candidate = candidates.top ();
+      candidates.pop ();
+      const std::vector<uint16_t> &combination = validCombinations.at (candidate.combinationIdx);
       // Create a MIMO antenna combination from the feedback candidate by removing the Rx antenna ID.
       MIMO_ANTENNA_COMBINATION combinaton;
-      for (MIMO_FEEDBACK_COMBINATION_I insideIt = it->second.begin (); insideIt != it->second.end (); insideIt++)
+      for (uint16_t i = 0; i < combination.size (); i++)
         {
-          ANTENNA_CONFIGURATION config = std::make_pair (std::get<0> (*insideIt), std::get<2> (*insideIt));
-          combinaton.push_back (config);
+          const MIMO_FEEDBACK_CONFIGURATION &feedbackConfig = sortedLists.at (combination.at (i)).at (candidate.positions.at (i))->second;
+          combinaton.push_back (std::make_pair (std::get<0> (feedbackConfig), std::get<2> (feedbackConfig)));
         }
       // Check if this combination has already been added, and if it hasn't been add it to the list of candidates
-      MIMO_ANTENNA_COMBINATIONS_LIST::iterator sameConfig = std::find (kBestCombinations.begin (), kBestCombinations.end (), combinaton);
-      if (sameConfig == kBestCombinations.end ())
+      if (addedCombinations.insert (combinaton).second)
         {
           kBestCombinations.push_back (combinaton);
         }
-      // If the list of candidates is K break since we have the full list of candidates
-      if (kBestCombinations.size () == k)
-        break;
+      // Push the successors of the candidate - move one position down the list of each Tx-Rx pair up to its first non-zero position.
+      for (uint16_t i = 0; i < combination.size (); i++)
+        {
+          if (candidate.positions.at (i) + 1u < sortedLists.at (combination.at (i)).size ())
+            {
+              MimoCandidate successor;
+              successor.combinationIdx = candidate.combinationIdx;
+              successor.positions = candidate.positions;
+              successor.positions.at (i)++;
+              successor.snr = getJointSnr (successor.combinationIdx, successor.positions);
+              candidates.push (successor);
+            }
+          if (candidate.positions.at (i) != 0)
+            break;
+        }
     }
   return kBestCombinations;
 }
@@ -3479,16 +3520,9 @@ DmgWifiMac::FindBestTxCombinations (uint8_t nBestCombinations, uint16_t rxCombin
   uint16_t txCombinationsTested = measurements.size () / (rxCombinationsTested);
   std::priority_queue<std::pair<double, SU_MIMO_ANTENNA2ANTENNA>> antenna2antennaQueue;
 
-  // Find all possible valid combinations of valid Tx-Rx pairs for the nTxAntennas streams we want to set up
-  std::vector<std::vector<uint16_t>> validTxRxPairs;
-  std::vector<uint16_t> currentCombination;
-  std::vector<uint16_t> indexes;
-  for (uint16_t i = 0; i < nTxAntennas * nRxAntennas; i++)
-    indexes.push_back (i);
-  if (nTxAntennas <= nRxAntennas)
-    FindAllValidTxRxPairs (0, nTxAntennas, nRxAntennas, validTxRxPairs, currentCombination, indexes);
-  else
-    FindAllValidTxRxPairs (0, nRxAntennas, nRxAntennas, validTxRxPairs, currentCombination, indexes);
+  // The number of streams we can set up is limited by the number of Tx and the number of Rx antennas
+  uint8_t nStreams = std::min (nTxAntennas, nRxAntennas);
+  MimoAssignmentSolver solver (nTxAntennas, nRxAntennas);
 
   /* For each Tx combination tested create all possible Rx combinations with the different addresses. */
   MIMO_SNR_LIST_I txStartIt = measurements.begin ();
@@ -3509,14 +3543,14 @@ DmgWifiMac::FindBestTxCombinations (uint8_t nBestCombinations, uint16_t rxCombin
       // While we haven't checked all possible combinations
       while (!endOfFinalList)
         {
-          MIMO_SNR_LIST combination;
+          std::vector<MIMO_SNR_LIST_I> combination;
           std::vector<uint16_t> rxAwvIdx;
           bool endOfList = true;
           // For each Rx antenna
           for (auto &iterator : iter)
             {
               // Add the SNR Measurement and the Rx AWV Id of the antenna to the list
-              combination.push_back (*(iterator.first));
+              combination.push_back (iterator.first);
               rxAwvIdx.push_back (iterator.second);
               // If the previous antenna reached the end of measurements of the current Tx combination move forward
               if (endOfList)
@@ -3539,36 +3573,16 @@ DmgWifiMac::FindBestTxCombinations (uint8_t nBestCombinations, uint16_t rxCombin
           if (endOfList)
             endOfFinalList = true;
 
-          double maxMinSnr;
-          bool firstMax = true;
-          uint8_t bestTxRxPairIdx = 0; // TO-DO (Check with NINA)
-          uint8_t indexPairs = 0;
-          /* For this Rx combination check all valid Tx-Rx pairs for the different streams */
-          for (auto & validTxRxPair : validTxRxPairs)
+          /* For this Rx combination find the assignment of Tx-Rx pairs to the different streams that gives the maximum minimum SINR */
+          for (uint8_t tx = 0; tx < nTxAntennas; tx++)
             {
-              bool firstSnr = true;
-              /* Find the minimum SINR of all streams */
-              double minSnr = 0; // TO-DO (Check with NINA)
-              for (auto txRxPair : validTxRxPair)
-                {
-                  uint8_t index = (txRxPair + 1) % nRxAntennas;
-                  if (index == 0)
-                    index = nRxAntennas;
-                  if (firstSnr || combination.at (index-1).second.at (txRxPair) < minSnr)
-                    {
-                      minSnr = combination.at (index-1).second.at (txRxPair);
-                      firstSnr = false;
-                    }
-                }
-              /* Find the Tx-Rx pair that gives the maximum minimum SINR */
-              if (firstMax || minSnr > maxMinSnr)
+              for (uint8_t rx = 0; rx < nRxAntennas; rx++)
                 {
-                  maxMinSnr = minSnr;
-                  bestTxRxPairIdx = indexPairs;
-                  firstMax = false;
+                  solver.SetSnr (tx, rx, combination.at (rx)->second.at (tx * nRxAntennas + rx));
                 }
-              indexPairs++;
             }
+          solver.Solve (nStreams);
+          double maxMinSnr = solver.GetMaxMinSnr ();
           /* Save the Tx AWV id and the Rx AWV Ids that correspond to the combination we are currently testing and the minimum SINR associated with it. */
           MEASUREMENT_AWV_IDs measurementAwvId;
           measurementAwvId.first = i+1;
@@ -3582,7 +3596,7 @@ DmgWifiMac::FindBestTxCombinations (uint8_t nBestCombinations, uint16_t rxCombin
           if (m_suMimoBeamformingTraining)
             {
               SU_MIMO_ANTENNA2ANTENNA antenna2antenna;
-              for (auto txRxPair : validTxRxPairs.at (bestTxRxPairIdx))
+              for (auto txRxPair : solver.GetAssignment ())
                 {
                   uint16_t txId = std::floor (txRxPair / static_cast<double> (nRxAntennas)) + 1;
                   uint16_t rxId = (txRxPair % nRxAntennas) + 1;
@@ -3620,62 +3634,57 @@ DmgWifiMac::FindBestTxCombinations (uint8_t nBestCombinations, uint16_t rxCombin
 }
 
 MIMO_FEEDBACK_COMBINATION
-DmgWifiMac::FindOptimalMuMimoConfig (uint8_t nTx, uint8_t nRx, MIMO_FEEDBACK_MAP feedback, std::vector<uint16_t> txAwvIds)
-{
-  // Find all possible valid combinations of Tx-Rx pairs
-  std::vector<std::vector<uint16_t>> validTxRxPairs;
-  std::vector<uint16_t> currentCombination;
-  std::vector<uint16_t> indexes;
-  for (uint16_t i = 0; i < nTx * nRx; i++)
-    indexes.push_back (i);
-  FindAllValidTxRxPairs (0, nTx, nRx, validTxRxPairs, currentCombination, indexes);
-  std::vector<MIMO_FEEDBACK_COMBINATION> candidates;
-  std::vector<SNR> minSNRs;
+DmgWifiMac::FindOptimalMuMimoConfig (uint8_t nTx, uint8_t nRx, const MIMO_FEEDBACK_MAP &feedback,
+                                     const std::vector<uint16_t> &txAwvIds)
+{
+  uint8_t nStreams = nTx;
+  const AntennaList &antennaIdList = m_codebook->GetCurrentMimoAntennaIdList ();
+  MimoAssignmentSolver solver (nTx, nRx);
+  MIMO_FEEDBACK_COMBINATION bestConfig;
+  SNR maxMinSnr = 0;
+  bool foundConfig = false;
   /* For all Tx configurations we have received feedback */
   for (auto & txAwvId : txAwvIds)
     {
-      /* Check all possible combinations of Tx-Rx pairs */
-      for (auto & txRxPairs : validTxRxPairs)
+      solver.Clear ();
+      for (uint8_t txId = 0; txId < nTx; txId++)
         {
-          MIMO_FEEDBACK_COMBINATION configs;
-          SNR minSNR;
-          bool firstConfig = true;
-          /* for all streams we want to establish */
-          for (auto & txRxPair : txRxPairs)
+          for (uint8_t rxIdx = 0; rxIdx < nRx; rxIdx++)
             {
               /* match the index to the Tx Antenna Id and the responder STA AID */
-              uint8_t txId = std::floor (txRxPair / static_cast <double> (nRx));
-              uint8_t rxId = (txRxPair % nRx);
+              uint8_t rxId = rxIdx;
               if (rxId == 0)
                 rxId = nRx;
-              uint8_t txAntennaId = m_codebook->GetCurrentMimoAntennaIdList ().at (txId);
-              uint8_t rxAid = m_edmgMuGroup.aidList.at (rxId - 1);
-              /* Check if the STA has sent back feedback for this TX configuration */
-              MIMO_FEEDBACK_CONFIGURATION config = std::make_tuple (txAntennaId, rxAid, txAwvId);
-              MIMO_FEEDBACK_MAP::iterator it = feedback.find (config);
+              /* Check if the STA has sent back feedback for this TX configuration - only Tx-Rx pairs
+               * with feedback can be part of a valid config */
+              MIMO_FEEDBACK_MAP::const_iterator it = feedback.find (std::make_tuple (antennaIdList.at (txId),
+                                                                                     m_edmgMuGroup.aidList.at (rxId - 1), txAwvId));
               if (it != feedback.end ())
-                {
-                  /* if we have feedback add the feedback config and check if it's the stream with the min SINR */
-                  configs.push_back (config);
-                  if (firstConfig || it->second < minSNR)
-                    {
-                      minSNR = it->second;
-                      firstConfig = false;
-                    }
-                }
+                solver.SetSnr (txId, rxIdx, it->second);
             }
-          /* If for this config we have received feedback from all STAs, it's a valid config to choose from*/
-          if (configs.size () == txRxPairs.size ())
+        }
+      /* Skip this Tx configuration if it can not give a higher minimum per-stream SINR than the best one so far */
+      if (foundConfig && solver.GetUpperBound (nStreams) <= maxMinSnr)
+        continue;
+      /* Find the combination of Tx-Rx pairs that gives the maximum minimum per-stream SINR */
+      if (solver.Solve (nStreams) && (!foundConfig || solver.GetMaxMinSnr () > maxMinSnr))
+        {
+          bestConfig.clear ();
+          for (auto & txRxPair : solver.GetAssignment ())
             {
-              candidates.push_back (configs);
-              minSNRs.push_back (minSNR);
+              uint8_t txId = std::floor (txRxPair / static_cast <double> (nRx));
+              uint8_t rxId = (txRxPair % nRx);
+              if (rxId == 0)
+                rxId = nRx;
+              bestConfig.push_back (std::make_tuple (antennaIdList.at (txId), m_edmgMuGroup.aidList.at (rxId - 1), txAwvId));
             }
+          maxMinSnr = solver.GetMaxMinSnr ();
+          foundConfig = true;
         }
     }
-  NS_ABORT_MSG_IF (minSNRs.empty (), "We have not received full feedback for any candidate so we can not choose the optimal MU-MIMO configuration");
+  NS_ABORT_MSG_IF (!foundConfig, "We have not received full feedback for any candidate so we can not choose the optimal MU-MIMO configuration");
   /* Choose the configuration that gives the maximum minimum per-stream SINR */
-  uint16_t maxIdx = std::distance(minSNRs.begin (), std::max_element (minSNRs.begin (), minSNRs.end ()));
-  return candidates.at (maxIdx);
+  return bestConfig;
 }
 
 DATA_COMMUNICATION_MODE
@@ -5016,31 +5025,28 @@ DmgWifiMac::GetBestAntennaConfiguration (const Mac48Address stationAddress, bool
 ANTENNA_CONFIGURATION
 DmgWifiMac::GetBestAntennaConfiguration (const Mac48Address stationAddress, bool isTxConfiguration, double &maxSnr)
 {
-  SNR_PAIR snrPair = m_stationSnrMap[stationAddress];
-  SNR_MAP snrMap;
-  if (isTxConfiguration)
-    {
-      snrMap = snrPair.first;
-    }
-  else
+  STATION_SNR_PAIR_MAP_CI it = m_stationSnrMap.find (stationAddress);
+  NS_ABORT_MSG_IF (it == m_stationSnrMap.end (), "Cannot find SNR table for communication with DMG STA=" << stationAddress);
+  BEST_SNR_PAIR &bestPair = m_stationBestSnrMap[stationAddress];
+  const SNR_MAP &snrMap = isTxConfiguration ? it->second.first : it->second.second;
+  BestSnrEntry &best = isTxConfiguration ? bestPair.first : bestPair.second;
+  if (!best.isValid)
     {
-      snrMap = snrPair.second;
-    }
-
-  SNR_MAP::iterator highIter = snrMap.begin ();
-  SNR snr = highIter->second;
-  maxSnr = snr;
-  for (SNR_MAP::iterator iter = snrMap.begin (); iter != snrMap.end (); iter++)
-    {
-      if (snr < iter->second)
+      NS_ABORT_MSG_IF (snrMap.empty (), "No SNR measurements available for DMG STA=" << stationAddress);
+      SNR_MAP::const_iterator highIter = snrMap.begin ();
+      for (SNR_MAP::const_iterator iter = snrMap.begin (); iter != snrMap.end (); iter++)
         {
-          highIter = iter;
-          snr = highIter->second;
-          maxSnr = snr;
+          if (highIter->second < iter->second)
+            {
+              highIter = iter;
+            }
         }
+      best.config = highIter->first;
+      best.snr = highIter->second;
+      best.isValid = true;
     }
-  ANTENNA_CONFIGURATION_COMBINATION config = highIter->first;
-  return std::make_pair (std::get<1> (config), std::get<2> (config));
+  maxSnr = best.snr;
+  return std::make_pair (std::get<1> (best.config), std::get<2> (best.config));
 }
 
 void
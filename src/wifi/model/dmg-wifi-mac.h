@@ -705,7 +705,7 @@ public:
    */
   void FindAllValidCombinations (uint16_t offset, uint16_t nStreams, MIMO_FEEDBACK_SORTED_MAPS &txRxCombinations,
                                  std::vector<std::vector<uint16_t>> &validCombinations, std::vector<uint16_t> &currentCombination ,
-                                 std::vector<uint16_t> indexes);
+                                 const std::vector<uint16_t> &indexes);
   /**
    * Find all possible combinations of Tx-Rx pairs that we should check - when establishing nStreams we need
    * to match each Tx antenna to an Rx antenna, making sure that no Tx or Rx Antennad appears twice in different
@@ -722,7 +722,7 @@ public:
    */
   void FindAllValidTxRxPairs (uint16_t offset, uint8_t nStreams, uint8_t nRx,
                              std::vector<std::vector<uint16_t> > &validTxRxPairs, std::vector<uint16_t> &currentCombination ,
-                             std::vector<uint16_t> indexes);
+                             const std::vector<uint16_t> &indexes);
   /**
    * From a given feedback with measurements from the SISO phase of MIMO Beamforming training
    * find the K best candidates to test in the MIMO phase ranking the candidates according to the joint SINR.
@@ -755,9 +755,11 @@ public:
    * \param nTx The number of Tx antennas that are being tested
    * \param nRx The number of STAs which are being trained
    * \param feedback The feedback list that contains all the feedback fiven by stations done in the MIMO phase.
+   * \param txAwvIds The Tx AWV IDs of the configurations that were tested in the MIMO phase.
    * \return The Tx ID associated with the optimal antenna configuration.
    */
-  MIMO_FEEDBACK_COMBINATION FindOptimalMuMimoConfig (uint8_t nTx, uint8_t nRx, MIMO_FEEDBACK_MAP feedback, std::vector<uint16_t> txAwvIds);
+  MIMO_FEEDBACK_COMBINATION FindOptimalMuMimoConfig (uint8_t nTx, uint8_t nRx, const MIMO_FEEDBACK_MAP &feedback,
+                                                     const std::vector<uint16_t> &txAwvIds);
   /**
    * Get the current communication mode with the station (SISO, SU-MIMO or MU-MIMO) from the Data Communication
    * Mode table. In case there is no entry for the station the default mode is SISO.
@@ -1209,6 +1211,16 @@ protected:
   typedef STATION_SNR_PAIR_MAP::iterator        STATION_SNR_PAIR_MAP_I; /* Typedef for iterator over SNR MAPPING Table. */
   typedef STATION_SNR_PAIR_MAP::const_iterator  STATION_SNR_PAIR_MAP_CI;/* Typedef for const iterator over SNR MAPPING Table. */
 
+  /* Typedefs for Tracking the Highest SNR in each SNR Table */
+  struct BestSnrEntry
+  {
+    ANTENNA_CONFIGURATION_COMBINATION config;   //!< The antenna configuration with the highest SNR.
+    SNR snr;                                    //!< The highest SNR in the SNR table.
+    bool isValid;                               //!< Flag to indicate whether the entry is up to date with the SNR table.
+  };
+  typedef std::pair<BestSnrEntry, BestSnrEntry> BEST_SNR_PAIR;          /* Typedef for the best TX and RX entries of an SNR Table. */
+  typedef std::map<Mac48Address, BEST_SNR_PAIR> STATION_BEST_SNR_MAP;   /* Typedef for Map between stations and the best entries of their SNR Table. */
+
   /* Typedefs for Recording Best Antenna Configuration per Station */
   typedef ANTENNA_CONFIGURATION ANTENNA_CONFIGURATION_TX;               /* Typedef for best TX antenna configuration. */
   typedef ANTENNA_CONFIGURATION ANTENNA_CONFIGURATION_RX;               /* Typedef for best RX antenna configuration. */
@@ -1289,6 +1301,16 @@ protected:
    * \param maxSnr The SNR value corresponding to the BEst Antenna Configuration.
    */
   ANTENNA_CONFIGURATION GetBestAntennaConfiguration (const Mac48Address stationAddress, bool isTxConfiguration, double &maxSnr);
+  /**
+   * Update the best entry of an SNR table after a new SNR value has been recorded in it. The entry is
+   * invalidated when the SNR of the current best antenna configuration decreases.
+   * \param best The best entry of the SNR table.
+   * \param snrMap The SNR table after recording the new SNR value.
+   * \param config The antenna configuration for which the SNR value has been recorded.
+   * \param snr The recorded SNR value.
+   */
+  static void UpdateBestSnr (BestSnrEntry &best, const SNR_MAP &snrMap,
+                             const ANTENNA_CONFIGURATION_COMBINATION &config, SNR snr);
   /**
    * Update Best Tx AWV ID towards specific station.
    * \param stationAddress The MAC address of the peer station.
@@ -1471,6 +1493,7 @@ protected:
 
 protected:
   STATION_SNR_PAIR_MAP m_stationSnrMap;                   //!< Map between peer stations and their SNR Table.
+  STATION_BEST_SNR_MAP m_stationBestSnrMap;               //!< Map between peer stations and the best entries of their SNR Table.
   STATION_ANTENNA_CONFIG_MAP m_bestAntennaConfig;         //!< Map between peer stations and the best antenna configuration.
   STATION_AWV_MAP m_bestAwvConfig;                        //!< Map between peer stations and the best AWV - to be used together with m_bestAntennaConfig.
   ANTENNA_CONFIGURATION m_feedbackAntennaConfig;          //!< Temporary variable to save the best antenna configuration of the peer station.
@@ -2064,6 +2064,12 @@ DmgWifiPhy::PrepareForAGC_RX_Reception (uint8_t remainingAgcRxSubields)
     }
 }
 
+Mac48Address
+DmgWifiPhy::GetCurrentSender (void) const
+{
+  return m_currentSender;
+}
+
 uint8_t
 DmgWifiPhy::GetBeaconTrnFieldLength (void) const
 {
@@ -2341,185 +2347,174 @@ DmgWifiPhy::Configure80211ay (void)
     }
 }
 
+/**
+ * Descriptor of a DMG or EDMG MCS, holding the parameters used to create its WifiMode.
+ */
+struct DmgMcsDescriptor
+{
+  const char *name;                 //!< The unique name of the WifiMode.
+  WifiModulationClass modClass;     //!< The modulation class.
+  bool isMandatory;                 //!< Whether the MCS is mandatory.
+  uint64_t dataRate;                //!< The data rate in bps.
+  WifiCodeRate codeRate;            //!< The code rate.
+  uint16_t constellationSize;       //!< The constellation size.
+};
+
+/**
+ * The bandwidth of a DMG/EDMG channel in Hz.
+ */
+static constexpr uint64_t DMG_CHANNEL_BANDWIDTH = 2160000000;
+
+/**
+ * The DMG MCSs defined in IEEE 802.11-2016 indexed by MCS.
+ */
+static constexpr DmgMcsDescriptor DMG_MCS_TABLE[] = {
+  { "DMG_MCS0",  WIFI_MOD_CLASS_DMG_CTRL,  true,  27500000,      WIFI_CODE_RATE_1_2,   2  },
+  { "DMG_MCS1",  WIFI_MOD_CLASS_DMG_SC,    true,  385000000,     WIFI_CODE_RATE_1_4,   2  }, /* 2 repetition */
+  { "DMG_MCS2",  WIFI_MOD_CLASS_DMG_SC,    true,  770000000,     WIFI_CODE_RATE_1_2,   2  },
+  { "DMG_MCS3",  WIFI_MOD_CLASS_DMG_SC,    true,  962500000,     WIFI_CODE_RATE_5_8,   2  },
+  { "DMG_MCS4",  WIFI_MOD_CLASS_DMG_SC,    true,  1155000000,    WIFI_CODE_RATE_3_4,   2  }, /* VHT SC MCS1-4 mandatory */
+  { "DMG_MCS5",  WIFI_MOD_CLASS_DMG_SC,    false, 1251250000,    WIFI_CODE_RATE_13_16, 2  },
+  { "DMG_MCS6",  WIFI_MOD_CLASS_DMG_SC,    false, 1540000000,    WIFI_CODE_RATE_1_2,   4  },
+  { "DMG_MCS7",  WIFI_MOD_CLASS_DMG_SC,    false, 1925000000,    WIFI_CODE_RATE_5_8,   4  },
+  { "DMG_MCS8",  WIFI_MOD_CLASS_DMG_SC,    false, 2310000000ULL, WIFI_CODE_RATE_3_4,   4  },
+  { "DMG_MCS9",  WIFI_MOD_CLASS_DMG_SC,    false, 2502500000ULL, WIFI_CODE_RATE_13_16, 4  },
+  { "DMG_MCS10", WIFI_MOD_CLASS_DMG_SC,    false, 3080000000ULL, WIFI_CODE_RATE_1_2,   16 },
+  { "DMG_MCS11", WIFI_MOD_CLASS_DMG_SC,    false, 3850000000ULL, WIFI_CODE_RATE_5_8,   16 },
+  { "DMG_MCS12", WIFI_MOD_CLASS_DMG_SC,    false, 4620000000ULL, WIFI_CODE_RATE_3_4,   16 },
+  { "DMG_MCS13", WIFI_MOD_CLASS_DMG_OFDM,  true,  693000000ULL,  WIFI_CODE_RATE_1_2,   2  },
+  { "DMG_MCS14", WIFI_MOD_CLASS_DMG_OFDM,  false, 866250000ULL,  WIFI_CODE_RATE_5_8,   2  },
+  { "DMG_MCS15", WIFI_MOD_CLASS_DMG_OFDM,  false, 1386000000ULL, WIFI_CODE_RATE_1_2,   4  },
+  { "DMG_MCS16", WIFI_MOD_CLASS_DMG_OFDM,  false, 1732500000ULL, WIFI_CODE_RATE_5_8,   4  },
+  { "DMG_MCS17", WIFI_MOD_CLASS_DMG_OFDM,  false, 2079000000ULL, WIFI_CODE_RATE_3_4,   4  },
+  { "DMG_MCS18", WIFI_MOD_CLASS_DMG_OFDM,  false, 2772000000ULL, WIFI_CODE_RATE_1_2,   16 },
+  { "DMG_MCS19", WIFI_MOD_CLASS_DMG_OFDM,  false, 3465000000ULL, WIFI_CODE_RATE_5_8,   16 },
+  { "DMG_MCS20", WIFI_MOD_CLASS_DMG_OFDM,  false, 4158000000ULL, WIFI_CODE_RATE_3_4,   16 },
+  { "DMG_MCS21", WIFI_MOD_CLASS_DMG_OFDM,  false, 4504500000ULL, WIFI_CODE_RATE_13_16, 16 },
+  { "DMG_MCS22", WIFI_MOD_CLASS_DMG_OFDM,  false, 5197500000ULL, WIFI_CODE_RATE_5_8,   64 },
+  { "DMG_MCS23", WIFI_MOD_CLASS_DMG_OFDM,  false, 6237000000ULL, WIFI_CODE_RATE_3_4,   64 },
+  { "DMG_MCS24", WIFI_MOD_CLASS_DMG_OFDM,  false, 6756750000ULL, WIFI_CODE_RATE_13_16, 64 },
+  { "DMG_MCS25", WIFI_MOD_CLASS_DMG_LP_SC, false, 626000000,     WIFI_CODE_RATE_13_28, 2  },
+  { "DMG_MCS26", WIFI_MOD_CLASS_DMG_LP_SC, false, 834000000,     WIFI_CODE_RATE_13_21, 2  },
+  { "DMG_MCS27", WIFI_MOD_CLASS_DMG_LP_SC, false, 1112000000ULL, WIFI_CODE_RATE_52_63, 2  },
+  { "DMG_MCS28", WIFI_MOD_CLASS_DMG_LP_SC, false, 1251000000ULL, WIFI_CODE_RATE_13_28, 2  },
+  { "DMG_MCS29", WIFI_MOD_CLASS_DMG_LP_SC, false, 1668000000ULL, WIFI_CODE_RATE_13_21, 4  },
+  { "DMG_MCS30", WIFI_MOD_CLASS_DMG_LP_SC, false, 2224000000ULL, WIFI_CODE_RATE_52_63, 4  },
+  { "DMG_MCS31", WIFI_MOD_CLASS_DMG_LP_SC, false, 2503000000ULL, WIFI_CODE_RATE_13_14, 4  },
+};
+
+/**
+ * The EDMG Control PHY MCS.
+ */
+static constexpr DmgMcsDescriptor EDMG_CTRL_MCS = { "EDMG_MCS0", WIFI_MOD_CLASS_EDMG_CTRL, true, 27500000, WIFI_CODE_RATE_1_2, 2 };
+
+/**
+ * The EDMG SC MCSs (Normal GI) defined in IEEE 802.11ay D5.0 indexed by MCS - 1.
+ */
+static constexpr DmgMcsDescriptor EDMG_SC_MCS_TABLE[] = {
+  { "EDMG_SC_MCS1",  WIFI_MOD_CLASS_EDMG_SC, true,  385000000,     WIFI_CODE_RATE_1_4,   2  }, /* 2 repetition */
+  { "EDMG_SC_MCS2",  WIFI_MOD_CLASS_EDMG_SC, true,  770000000,     WIFI_CODE_RATE_1_2,   2  },
+  { "EDMG_SC_MCS3",  WIFI_MOD_CLASS_EDMG_SC, true,  962500000,     WIFI_CODE_RATE_5_8,   2  },
+  { "EDMG_SC_MCS4",  WIFI_MOD_CLASS_EDMG_SC, true,  1155000000,    WIFI_CODE_RATE_3_4,   2  },
+  { "EDMG_SC_MCS5",  WIFI_MOD_CLASS_EDMG_SC, false, 1251250000,    WIFI_CODE_RATE_13_16, 2  },
+  { "EDMG_SC_MCS6",  WIFI_MOD_CLASS_EDMG_SC, false, 1347500000,    WIFI_CODE_RATE_7_8,   2  },
+  { "EDMG_SC_MCS7",  WIFI_MOD_CLASS_EDMG_SC, false, 1540000000,    WIFI_CODE_RATE_1_2,   4  },
+  { "EDMG_SC_MCS8",  WIFI_MOD_CLASS_EDMG_SC, false, 1925000000ULL, WIFI_CODE_RATE_5_8,   4  },
+  { "EDMG_SC_MCS9",  WIFI_MOD_CLASS_EDMG_SC, false, 2310000000ULL, WIFI_CODE_RATE_3_4,   4  },
+  { "EDMG_SC_MCS10", WIFI_MOD_CLASS_EDMG_SC, false, 2502500000ULL, WIFI_CODE_RATE_13_16, 4  },
+  { "EDMG_SC_MCS11", WIFI_MOD_CLASS_EDMG_SC, false, 2695000000ULL, WIFI_CODE_RATE_7_8,   4  },
+  { "EDMG_SC_MCS12", WIFI_MOD_CLASS_EDMG_SC, false, 3080000000ULL, WIFI_CODE_RATE_1_2,   16 },
+  { "EDMG_SC_MCS13", WIFI_MOD_CLASS_EDMG_SC, false, 3850000000ULL, WIFI_CODE_RATE_5_8,   16 },
+  { "EDMG_SC_MCS14", WIFI_MOD_CLASS_EDMG_SC, false, 4620000000ULL, WIFI_CODE_RATE_3_4,   16 },
+  { "EDMG_SC_MCS15", WIFI_MOD_CLASS_EDMG_SC, false, 5005000000ULL, WIFI_CODE_RATE_13_16, 16 },
+  { "EDMG_SC_MCS16", WIFI_MOD_CLASS_EDMG_SC, false, 5390000000ULL, WIFI_CODE_RATE_7_8,   16 },
+  { "EDMG_SC_MCS17", WIFI_MOD_CLASS_EDMG_SC, false, 4620000000ULL, WIFI_CODE_RATE_1_2,   64 },
+  { "EDMG_SC_MCS18", WIFI_MOD_CLASS_EDMG_SC, false, 5775000000ULL, WIFI_CODE_RATE_5_8,   64 },
+  { "EDMG_SC_MCS19", WIFI_MOD_CLASS_EDMG_SC, false, 6930000000ULL, WIFI_CODE_RATE_3_4,   64 },
+  { "EDMG_SC_MCS20", WIFI_MOD_CLASS_EDMG_SC, false, 7507500000ULL, WIFI_CODE_RATE_13_16, 64 },
+  { "EDMG_SC_MCS21", WIFI_MOD_CLASS_EDMG_SC, false, 8085000000ULL, WIFI_CODE_RATE_7_8,   64 },
+};
+
+/**
+ * The EDMG OFDM MCSs (NSD = 336, Short GI) defined in IEEE 802.11ay D5.0 indexed by MCS - 1.
+ */
+static constexpr DmgMcsDescriptor EDMG_OFDM_MCS_TABLE[] = {
+  { "EDMG_OFDM_MCS1",  WIFI_MOD_CLASS_EDMG_OFDM, true,  792000000ULL,  WIFI_CODE_RATE_1_2,   2  },
+  { "EDMG_OFDM_MCS2",  WIFI_MOD_CLASS_EDMG_OFDM, false, 990000000ULL,  WIFI_CODE_RATE_5_8,   2  },
+  { "EDMG_OFDM_MCS3",  WIFI_MOD_CLASS_EDMG_OFDM, false, 1188000000ULL, WIFI_CODE_RATE_3_4,   2  },
+  { "EDMG_OFDM_MCS4",  WIFI_MOD_CLASS_EDMG_OFDM, false, 1287000000ULL, WIFI_CODE_RATE_13_16, 2  },
+  { "EDMG_OFDM_MCS5",  WIFI_MOD_CLASS_EDMG_OFDM, false, 1386000000ULL, WIFI_CODE_RATE_7_8,   2  },
+  { "EDMG_OFDM_MCS6",  WIFI_MOD_CLASS_EDMG_OFDM, false, 1584000000ULL, WIFI_CODE_RATE_1_2,   4  },
+  { "EDMG_OFDM_MCS7",  WIFI_MOD_CLASS_EDMG_OFDM, false, 1980000000ULL, WIFI_CODE_RATE_5_8,   4  },
+  { "EDMG_OFDM_MCS8",  WIFI_MOD_CLASS_EDMG_OFDM, false, 2376000000ULL, WIFI_CODE_RATE_3_4,   4  },
+  { "EDMG_OFDM_MCS9",  WIFI_MOD_CLASS_EDMG_OFDM, false, 2574000000ULL, WIFI_CODE_RATE_13_16, 4  },
+  { "EDMG_OFDM_MCS10", WIFI_MOD_CLASS_EDMG_OFDM, false, 2772000000ULL, WIFI_CODE_RATE_7_8,   4  },
+  { "EDMG_OFDM_MCS11", WIFI_MOD_CLASS_EDMG_OFDM, false, 3168000000ULL, WIFI_CODE_RATE_1_2,   16 },
+  { "EDMG_OFDM_MCS12", WIFI_MOD_CLASS_EDMG_OFDM, false, 3960000000ULL, WIFI_CODE_RATE_5_8,   16 },
+  { "EDMG_OFDM_MCS13", WIFI_MOD_CLASS_EDMG_OFDM, false, 4752000000ULL, WIFI_CODE_RATE_3_4,   16 },
+  { "EDMG_OFDM_MCS14", WIFI_MOD_CLASS_EDMG_OFDM, false, 5148000000ULL, WIFI_CODE_RATE_13_16, 16 },
+  { "EDMG_OFDM_MCS15", WIFI_MOD_CLASS_EDMG_OFDM, false, 5544000000ULL, WIFI_CODE_RATE_7_8,   16 },
+  { "EDMG_OFDM_MCS16", WIFI_MOD_CLASS_EDMG_OFDM, false, 4752000000ULL, WIFI_CODE_RATE_1_2,   64 },
+  { "EDMG_OFDM_MCS17", WIFI_MOD_CLASS_EDMG_OFDM, false, 5940000000ULL, WIFI_CODE_RATE_5_8,   64 },
+  { "EDMG_OFDM_MCS18", WIFI_MOD_CLASS_EDMG_OFDM, false, 7128000000ULL, WIFI_CODE_RATE_3_4,   64 },
+  { "EDMG_OFDM_MCS19", WIFI_MOD_CLASS_EDMG_OFDM, false, 7722000000ULL, WIFI_CODE_RATE_13_16, 64 },
+  { "EDMG_OFDM_MCS20", WIFI_MOD_CLASS_EDMG_OFDM, false, 8316000000ULL, WIFI_CODE_RATE_7_8,   64 },
+};
+
+/**
+ * Return the WifiMode of the given MCS, creating it from its descriptor the first time it is requested.
+ * \param modes The WifiModes created so far for the descriptor table, indexed as the table.
+ * \param descriptor The descriptor of the MCS.
+ * \param index The index of the MCS in its table.
+ * \param mcs The MCS value.
+ * \return The WifiMode of the MCS.
+ */
+static WifiMode
+GetMcsFromTable (WifiMode *modes, const DmgMcsDescriptor &descriptor, uint8_t index, uint8_t mcs)
+{
+  /* WifiMode UID 0 is the invalid mode, so it marks the modes that have not been created yet. */
+  if (modes[index].GetUid () == 0)
+    {
+      modes[index] = WifiModeFactory::CreateWifiMode (descriptor.name, mcs,
+                                                      descriptor.modClass,
+                                                      descriptor.isMandatory,
+                                                      DMG_CHANNEL_BANDWIDTH, descriptor.dataRate,
+                                                      descriptor.codeRate,
+                                                      descriptor.constellationSize);
+    }
+  return modes[index];
+}
+
 WifiMode
 DmgWifiPhy::GetDmgMcs (uint8_t index)
 {
-  switch (index)
-  {
-    case 0:
-      return GetDMG_MCS0 ();
-    case 1:
-      return GetDMG_MCS1 ();
-    case 2:
-      return GetDMG_MCS2 ();
-    case 3:
-      return GetDMG_MCS3 ();
-    case 4:
-      return GetDMG_MCS4 ();
-    case 5:
-      return GetDMG_MCS5 ();
-    case 6:
-      return GetDMG_MCS6 ();
-    case 7:
-      return GetDMG_MCS7 ();
-    case 8:
-      return GetDMG_MCS8 ();
-    case 9:
-      return GetDMG_MCS9 ();
-    case 10:
-      return GetDMG_MCS10 ();
-    case 11:
-      return GetDMG_MCS11 ();
-    case 12:
-      return GetDMG_MCS12 ();
-    case 13:
-      return GetDMG_MCS13 ();
-    case 14:
-      return GetDMG_MCS14 ();
-    case 15:
-      return GetDMG_MCS15 ();
-    case 16:
-      return GetDMG_MCS16 ();
-    case 17:
-      return GetDMG_MCS17 ();
-    case 18:
-      return GetDMG_MCS18 ();
-    case 19:
-      return GetDMG_MCS19 ();
-    case 20:
-      return GetDMG_MCS20 ();
-    case 21:
-      return GetDMG_MCS21 ();
-    case 22:
-      return GetDMG_MCS22 ();
-    case 23:
-      return GetDMG_MCS23 ();
-    case 24:
-      return GetDMG_MCS24 ();
-    case 25:
-      return GetDMG_MCS25 ();
-    case 26:
-      return GetDMG_MCS26 ();
-    case 27:
-      return GetDMG_MCS27 ();
-    case 28:
-      return GetDMG_MCS28 ();
-    case 29:
-      return GetDMG_MCS29 ();
-    case 30:
-      return GetDMG_MCS30 ();
-    case 31:
-      return GetDMG_MCS31 ();
-    default:
-      NS_ABORT_MSG ("Inexistent (or not supported) index (" << +index << ") requested for DMG PHY");
-      return WifiMode ();
-    }
+  static const uint8_t count = sizeof (DMG_MCS_TABLE) / sizeof (DmgMcsDescriptor);
+  static WifiMode modes[count];
+  NS_ABORT_MSG_IF (index >= count, "Inexistent (or not supported) index (" << +index << ") requested for DMG PHY");
+  return GetMcsFromTable (modes, DMG_MCS_TABLE[index], index, index);
 }
 
 WifiMode
 DmgWifiPhy::GetEdmgMcs (WifiModulationClass modulation, uint8_t index)
 {
   if (modulation == WIFI_MOD_CLASS_EDMG_CTRL)
-    return GetEDMG_MCS0 ();
+    {
+      static WifiMode mode;
+      return GetMcsFromTable (&mode, EDMG_CTRL_MCS, 0, 0);
+    }
   else if (modulation == WIFI_MOD_CLASS_EDMG_SC)
     {
-      switch (index)
-      {
-        case 1:
-          return GetEDMG_SC_MCS1 ();
-        case 2:
-          return GetEDMG_SC_MCS2 ();
-        case 3:
-          return GetEDMG_SC_MCS3 ();
-        case 4:
-          return GetEDMG_SC_MCS4 ();
-        case 5:
-          return GetEDMG_SC_MCS5 ();
-        case 6:
-          return GetEDMG_SC_MCS6 ();
-        case 7:
-          return GetEDMG_SC_MCS7 ();
-        case 8:
-          return GetEDMG_SC_MCS8 ();
-        case 9:
-          return GetEDMG_SC_MCS9 ();
-        case 10:
-          return GetEDMG_SC_MCS10 ();
-        case 11:
-          return GetEDMG_SC_MCS11 ();
-        case 12:
-          return GetEDMG_SC_MCS12 ();
-        case 13:
-          return GetEDMG_SC_MCS13 ();
-        case 14:
-          return GetEDMG_SC_MCS14 ();
-        case 15:
-          return GetEDMG_SC_MCS15 ();
-        case 16:
-          return GetEDMG_SC_MCS16 ();
-        case 17:
-          return GetEDMG_SC_MCS17 ();
-        case 18:
-          return GetEDMG_SC_MCS18 ();
-        case 19:
-          return GetEDMG_SC_MCS19 ();
-        case 20:
-          return GetEDMG_SC_MCS20 ();
-        case 21:
-          return GetEDMG_SC_MCS21 ();
-        default:
-          NS_ABORT_MSG ("Inexistent (or not supported) index (" << +index << ") requested for DMG PHY");
-          return WifiMode ();
-      }
+      static const uint8_t count = sizeof (EDMG_SC_MCS_TABLE) / sizeof (DmgMcsDescriptor);
+      static WifiMode modes[count];
+      NS_ABORT_MSG_IF (index < 1 || index > count, "Inexistent (or not supported) index (" << +index << ") requested for DMG PHY");
+      return GetMcsFromTable (modes, EDMG_SC_MCS_TABLE[index - 1], index - 1, index);
     }
   else if (modulation == WIFI_MOD_CLASS_EDMG_OFDM)
     {
-      switch (index)
-      {
-        case 1:
-          return GetEDMG_OFDM_MCS1 ();
-        case 2:
-          return GetEDMG_OFDM_MCS2 ();
-        case 3:
-          return GetEDMG_OFDM_MCS3 ();
-        case 4:
-          return GetEDMG_OFDM_MCS4 ();
-        case 5:
-          return GetEDMG_OFDM_MCS5 ();
-        case 6:
-          return GetEDMG_OFDM_MCS6 ();
-        case 7:
-          return GetEDMG_OFDM_MCS7 ();
-        case 8:
-          return GetEDMG_OFDM_MCS8 ();
-        case 9:
-          return GetEDMG_OFDM_MCS9 ();
-        case 10:
-          return GetEDMG_OFDM_MCS10 ();
-        case 11:
-          return GetEDMG_OFDM_MCS11 ();
-        case 12:
-          return GetEDMG_OFDM_MCS12 ();
-        case 13:
-          return GetEDMG_OFDM_MCS13 ();
-        case 14:
-          return GetEDMG_OFDM_MCS14 ();
-        case 15:
-          return GetEDMG_OFDM_MCS15 ();
-        case 16:
-          return GetEDMG_OFDM_MCS16 ();
-        case 17:
-          return GetEDMG_OFDM_MCS17 ();
-        case 18:
-          return GetEDMG_OFDM_MCS18 ();
-        case 19:
-          return GetEDMG_OFDM_MCS19 ();
-        case 20:
-          return GetEDMG_OFDM_MCS20 ();
-        default:
-          NS_ABORT_MSG ("Inexistent (or not supported) index (" << +index << ") requested for DMG PHY");
-          return WifiMode ();
-      }
+      static const uint8_t count = sizeof (EDMG_OFDM_MCS_TABLE) / sizeof (DmgMcsDescriptor);
+      static WifiMode modes[count];
+      NS_ABORT_MSG_IF (index < 1 || index > count, "Inexistent (or not supported) index (" << +index << ") requested for DMG PHY");
+      return GetMcsFromTable (modes, EDMG_OFDM_MCS_TABLE[index - 1], index - 1, index);
     }
   else
     NS_FATAL_ERROR ("Unsupported EDMG modulation type");
@@ -2529,132 +2524,62 @@ DmgWifiPhy::GetEdmgMcs (WifiModulationClass modulation, uint8_t index)
 WifiMode
 DmgWifiPhy::GetDMG_MCS0 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS0", 0,
-                                     WIFI_MOD_CLASS_DMG_CTRL,
-                                     true,
-                                     2160000000, 27500000,
-                                     WIFI_CODE_RATE_1_2,
-                                     2);
-  return mode;
+  return GetDmgMcs (0);
 }
 
 /**** DMG SC PHY MCSs ****/
 WifiMode
 DmgWifiPhy::GetDMG_MCS1 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS1", 1,
-                                     WIFI_MOD_CLASS_DMG_SC,
-                                     true,
-                                     2160000000, 385000000,
-                                     WIFI_CODE_RATE_1_4, /* 2 repetition */
-                                     2);
-  return mode;
+  return GetDmgMcs (1);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS2 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS2", 2,
-                                     WIFI_MOD_CLASS_DMG_SC,
-                                     true,
-                                     2160000000, 770000000,
-                                     WIFI_CODE_RATE_1_2,
-                                     2);
-  return mode;
+  return GetDmgMcs (2);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS3 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS3", 3,
-                                     WIFI_MOD_CLASS_DMG_SC,
-                                     true,
-                                     2160000000, 962500000,
-                                     WIFI_CODE_RATE_5_8,
-                                     2);
-  return mode;
+  return GetDmgMcs (3);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS4 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS4", 4,
-                                     WIFI_MOD_CLASS_DMG_SC,
-                                     true, /* VHT SC MCS1-4 mandatory*/
-                                     2160000000, 1155000000,
-                                     WIFI_CODE_RATE_3_4,
-                                     2);
-  return mode;
+  return GetDmgMcs (4);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS5 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS5", 5,
-                                     WIFI_MOD_CLASS_DMG_SC,
-                                     false,
-                                     2160000000, 1251250000,
-                                     WIFI_CODE_RATE_13_16,
-                                     2);
-  return mode;
+  return GetDmgMcs (5);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS6 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS6", 6,
-                                     WIFI_MOD_CLASS_DMG_SC,
-                                     false,
-                                     2160000000, 1540000000,
-                                     WIFI_CODE_RATE_1_2,
-                                     4);
-  return mode;
+  return GetDmgMcs (6);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS7 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS7", 7,
-                                     WIFI_MOD_CLASS_DMG_SC,
-                                     false,
-                                     2160000000, 1925000000,
-                                     WIFI_CODE_RATE_5_8,
-                                     4);
-  return mode;
+  return GetDmgMcs (7);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS8 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS8", 8,
-                                     WIFI_MOD_CLASS_DMG_SC,
-                                     false,
-                                     2160000000, 2310000000ULL,
-                                     WIFI_CODE_RATE_3_4,
-                                     4);
-  return mode;
+  return GetDmgMcs (8);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS9 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS9", 9,
-                                     WIFI_MOD_CLASS_DMG_SC,
-                                     false,
-                                     2160000000, 2502500000ULL,
-                                     WIFI_CODE_RATE_13_16,
-                                     4);
-  return mode;
+  return GetDmgMcs (9);
 }
 
 /**** Extended SC MCS ****/
@@ -2674,41 +2599,20 @@ DmgWifiPhy::GetDMG_MCS9_1 (void)
 WifiMode
 DmgWifiPhy::GetDMG_MCS10 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS10", 10,
-                                     WIFI_MOD_CLASS_DMG_SC,
-                                     false,
-                                     2160000000, 3080000000ULL,
-                                     WIFI_CODE_RATE_1_2,
-                                     16);
-  return mode;
+  return GetDmgMcs (10);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS11 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS11", 11,
-                                     WIFI_MOD_CLASS_DMG_SC,
-                                     false,
-                                     2160000000, 3850000000ULL,
-                                     WIFI_CODE_RATE_5_8,
-                                     16);
-  return mode;
+  return GetDmgMcs (11);
 }
 
 /**** Extended SC MCSs Below ****/
 WifiMode
 DmgWifiPhy::GetDMG_MCS12 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS12", 12,
-                                     WIFI_MOD_CLASS_DMG_SC,
-                                     false,
-                                     2160000000, 4620000000ULL,
-                                     WIFI_CODE_RATE_3_4,
-                                     16);
-  return mode;
+  return GetDmgMcs (12);
 }
 
 WifiMode
@@ -2793,539 +2697,252 @@ DmgWifiPhy::GetDMG_MCS12_6 (void)
 WifiMode
 DmgWifiPhy::GetDMG_MCS13 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS13", 13,
-                                     WIFI_MOD_CLASS_DMG_OFDM,
-                                     true,
-                                     2160000000, 693000000ULL,
-                                     WIFI_CODE_RATE_1_2,
-                                     2);
-  return mode;
+  return GetDmgMcs (13);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS14 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS14", 14,
-                                     WIFI_MOD_CLASS_DMG_OFDM,
-                                     false,
-                                     2160000000, 866250000ULL,
-                                     WIFI_CODE_RATE_5_8,
-                                     2);
-  return mode;
+  return GetDmgMcs (14);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS15 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS15", 15,
-                                     WIFI_MOD_CLASS_DMG_OFDM,
-                                     false,
-                                     2160000000, 1386000000ULL,
-                                     WIFI_CODE_RATE_1_2,
-                                     4);
-  return mode;
+  return GetDmgMcs (15);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS16 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS16", 16,
-                                     WIFI_MOD_CLASS_DMG_OFDM,
-                                     false,
-                                     2160000000, 1732500000ULL,
-                                     WIFI_CODE_RATE_5_8,
-                                     4);
-  return mode;
+  return GetDmgMcs (16);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS17 (void)
 {
-  static WifiMode mode =
-  WifiModeFactory::CreateWifiMode ("DMG_MCS17", 17,
-                                   WIFI_MOD_CLASS_DMG_OFDM,
-                                   false,
-                                   2160000000, 2079000000ULL,
-                                   WIFI_CODE_RATE_3_4,
-                                   4);
-  return mode;
+  return GetDmgMcs (17);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS18 (void)
 {
-  static WifiMode mode =
-  WifiModeFactory::CreateWifiMode ("DMG_MCS18", 18,
-                                   WIFI_MOD_CLASS_DMG_OFDM,
-                                   false,
-                                   2160000000, 2772000000ULL,
-                                   WIFI_CODE_RATE_1_2,
-                                   16);
-  return mode;
+  return GetDmgMcs (18);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS19 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS19", 19,
-                                     WIFI_MOD_CLASS_DMG_OFDM,
-                                     false,
-                                     2160000000, 3465000000ULL,
-                                     WIFI_CODE_RATE_5_8,
-                                     16);
-  return mode;
+  return GetDmgMcs (19);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS20 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS20", 20,
-                                     WIFI_MOD_CLASS_DMG_OFDM,
-                                     false,
-                                     2160000000, 4158000000ULL,
-                                     WIFI_CODE_RATE_3_4,
-                                     16);
-  return mode;
+  return GetDmgMcs (20);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS21 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS21", 21,
-                                     WIFI_MOD_CLASS_DMG_OFDM,
-                                     false,
-                                     2160000000, 4504500000ULL,
-                                     WIFI_CODE_RATE_13_16,
-                                     16);
-  return mode;
+  return GetDmgMcs (21);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS22 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS22", 22,
-                                     WIFI_MOD_CLASS_DMG_OFDM,
-                                     false,
-                                     2160000000, 5197500000ULL,
-                                     WIFI_CODE_RATE_5_8,
-                                     64);
-  return mode;
+  return GetDmgMcs (22);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS23 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS23", 23,
-                                     WIFI_MOD_CLASS_DMG_OFDM,
-                                     false,
-                                     2160000000, 6237000000ULL,
-                                     WIFI_CODE_RATE_3_4,
-                                     64);
-  return mode;
+  return GetDmgMcs (23);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS24 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS24", 24,
-                                     WIFI_MOD_CLASS_DMG_OFDM,
-                                     false,
-                                     2160000000, 6756750000ULL,
-                                     WIFI_CODE_RATE_13_16,
-                                     64);
-  return mode;
+  return GetDmgMcs (24);
 }
 
 /**** Low Power SC MCSs ****/
 WifiMode
 DmgWifiPhy::GetDMG_MCS25 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS25", 25,
-                                     WIFI_MOD_CLASS_DMG_LP_SC,
-                                     false,
-                                     2160000000, 626000000,
-                                     WIFI_CODE_RATE_13_28,
-                                     2);
-  return mode;
+  return GetDmgMcs (25);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS26 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS26", 26,
-                                     WIFI_MOD_CLASS_DMG_LP_SC,
-                                     false,
-                                     2160000000, 834000000,
-                                     WIFI_CODE_RATE_13_21,
-                                     2);
-  return mode;
+  return GetDmgMcs (26);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS27 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS27", 27,
-                                     WIFI_MOD_CLASS_DMG_LP_SC,
-                                     false,
-                                     2160000000, 1112000000ULL,
-                                     WIFI_CODE_RATE_52_63,
-                                     2);
-  return mode;
+  return GetDmgMcs (27);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS28 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS28", 28,
-                                     WIFI_MOD_CLASS_DMG_LP_SC,
-                                     false,
-                                     2160000000, 1251000000ULL,
-                                     WIFI_CODE_RATE_13_28,
-                                     2);
-  return mode;
+  return GetDmgMcs (28);
 }
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS29 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS29", 29,
-                                     WIFI_MOD_CLASS_DMG_LP_SC,
-                                     false,
-                                     2160000000, 1668000000ULL,
-                                     WIFI_CODE_RATE_13_21,
-                                     4);
-  return mode;
+  return GetDmgMcs (29);
 }
 
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS30 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS30", 30,
-                                     WIFI_MOD_CLASS_DMG_LP_SC,
-                                     false,
-                                     2160000000, 2224000000ULL,
-                                     WIFI_CODE_RATE_52_63,
-                                     4);
-  return mode;
+  return GetDmgMcs (30);
 }
 
 
 WifiMode
 DmgWifiPhy::GetDMG_MCS31 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("DMG_MCS31", 31,
-                                     WIFI_MOD_CLASS_DMG_LP_SC,
-                                     false,
-                                     2160000000, 2503000000ULL,
-                                     WIFI_CODE_RATE_13_14,
-                                     4);
-  return mode;
+  return GetDmgMcs (31);
 }
 
 /* EDMG Control PHY MCS */
 WifiMode
 DmgWifiPhy::GetEDMG_MCS0 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_MCS0", 0,
-                                     WIFI_MOD_CLASS_EDMG_CTRL,
-                                     true,
-                                     2160000000, 27500000,
-                                     WIFI_CODE_RATE_1_2,
-                                     2);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_CTRL, 0);
 }
 
 /**** EDMG SC PHY MCSs (Normal GI) ****/
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS1 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS1", 1,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     true,
-                                     2160000000, 385000000,
-                                     WIFI_CODE_RATE_1_4, /* 2 repetition */
-                                     2);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 1);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS2 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS2", 2,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     true,
-                                     2160000000, 770000000,
-                                     WIFI_CODE_RATE_1_2,
-                                     2);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 2);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS3 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS3", 3,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     true,
-                                     2160000000, 962500000,
-                                     WIFI_CODE_RATE_5_8,
-                                     2);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 3);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS4 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS4", 4,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     true,
-                                     2160000000, 1155000000,
-                                     WIFI_CODE_RATE_3_4,
-                                     2);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 4);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS5 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS5", 5,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 1251250000,
-                                     WIFI_CODE_RATE_13_16,
-                                     2);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 5);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS6 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS6", 6,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 1347500000,
-                                     WIFI_CODE_RATE_7_8,
-                                     2);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 6);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS7 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS7", 7,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 1540000000,
-                                     WIFI_CODE_RATE_1_2,
-                                     4);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 7);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS8 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS8", 8,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 1925000000ULL,
-                                     WIFI_CODE_RATE_5_8,
-                                     4);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 8);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS9 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS9", 9,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 2310000000ULL,
-                                     WIFI_CODE_RATE_3_4,
-                                     4);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 9);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS10 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS10", 10,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 2502500000ULL,
-                                     WIFI_CODE_RATE_13_16,
-                                     4);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 10);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS11 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS11", 11,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 2695000000ULL,
-                                     WIFI_CODE_RATE_7_8,
-                                     4);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 11);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS12 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS12", 12,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 3080000000ULL,
-                                     WIFI_CODE_RATE_1_2,
-                                     16);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 12);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS13 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS13", 13,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 3850000000ULL,
-                                     WIFI_CODE_RATE_5_8,
-                                     16);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 13);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS14 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS14", 14,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 4620000000ULL,
-                                     WIFI_CODE_RATE_3_4,
-                                     16);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 14);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS15 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS15", 15,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 5005000000ULL,
-                                     WIFI_CODE_RATE_13_16,
-                                     16);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 15);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS16 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS16", 16,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 5390000000ULL,
-                                     WIFI_CODE_RATE_7_8,
-                                     16);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 16);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS17 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS17", 17,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 4620000000ULL,
-                                     WIFI_CODE_RATE_1_2,
-                                     64);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 17);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS18 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS18", 18,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 5775000000ULL,
-                                     WIFI_CODE_RATE_5_8,
-                                     64);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 18);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS19 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS19", 19,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 6930000000ULL,
-                                     WIFI_CODE_RATE_3_4,
-                                     64);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 19);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS20 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS20", 20,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 7507500000ULL,
-                                     WIFI_CODE_RATE_13_16,
-                                     64);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 20);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_SC_MCS21 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_SC_MCS21", 21,
-                                     WIFI_MOD_CLASS_EDMG_SC,
-                                     false,
-                                     2160000000, 8085000000ULL,
-                                     WIFI_CODE_RATE_7_8,
-                                     64);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, 21);
 }
 
 /**** EDMG OFDM MCSs BELOW ****/
@@ -3338,261 +2955,121 @@ DmgWifiPhy::GetEDMG_SC_MCS21 (void)
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS1 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS1", 1,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     true,
-                                     2160000000, 792000000ULL,
-                                     WIFI_CODE_RATE_1_2,
-                                     2);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 1);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS2 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS2", 2,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 990000000ULL,
-                                     WIFI_CODE_RATE_5_8,
-                                     2);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 2);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS3 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS3", 3,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 1188000000ULL,
-                                     WIFI_CODE_RATE_3_4,
-                                     2);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 3);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS4 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS4", 4,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 1287000000ULL,
-                                     WIFI_CODE_RATE_13_16,
-                                     2);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 4);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS5 (void)
 {
-  static WifiMode mode =
-  WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS5", 5,
-                                   WIFI_MOD_CLASS_EDMG_OFDM,
-                                   false,
-                                   2160000000, 1386000000ULL,
-                                   WIFI_CODE_RATE_7_8,
-                                   2);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 5);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS6 (void)
 {
-  static WifiMode mode =
-  WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS6", 6,
-                                   WIFI_MOD_CLASS_EDMG_OFDM,
-                                   false,
-                                   2160000000, 1584000000ULL,
-                                   WIFI_CODE_RATE_1_2,
-                                   4);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 6);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS7 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS7", 7,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 1980000000ULL,
-                                     WIFI_CODE_RATE_5_8,
-                                     4);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 7);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS8 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS8", 8,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 2376000000ULL,
-                                     WIFI_CODE_RATE_3_4,
-                                     4);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 8);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS9 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS9", 9,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 2574000000ULL,
-                                     WIFI_CODE_RATE_13_16,
-                                     4);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 9);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS10 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS10", 10,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 2772000000ULL,
-                                     WIFI_CODE_RATE_7_8,
-                                     4);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 10);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS11 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS11", 11,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 3168000000ULL,
-                                     WIFI_CODE_RATE_1_2,
-                                     16);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 11);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS12 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS12", 12,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 3960000000ULL,
-                                     WIFI_CODE_RATE_5_8,
-                                     16);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 12);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS13 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS13", 13,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 4752000000ULL,
-                                     WIFI_CODE_RATE_3_4,
-                                     16);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 13);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS14 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS14", 14,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 5148000000ULL,
-                                     WIFI_CODE_RATE_13_16,
-                                     16);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 14);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS15 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS15", 15,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 5544000000ULL,
-                                     WIFI_CODE_RATE_7_8,
-                                     16);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 15);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS16 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS16", 16,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 4752000000ULL,
-                                     WIFI_CODE_RATE_1_2,
-                                     64);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 16);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS17 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS17", 17,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 5940000000ULL,
-                                     WIFI_CODE_RATE_5_8,
-                                     64);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 17);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS18 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS18", 18,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 7128000000ULL,
-                                     WIFI_CODE_RATE_3_4,
-                                     64);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 18);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS19 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS19", 19,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 7722000000ULL,
-                                     WIFI_CODE_RATE_13_16,
-                                     64);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 19);
 }
 
 WifiMode
 DmgWifiPhy::GetEDMG_OFDM_MCS20 (void)
 {
-  static WifiMode mode =
-    WifiModeFactory::CreateWifiMode ("EDMG_OFDM_MCS20", 20,
-                                     WIFI_MOD_CLASS_EDMG_OFDM,
-                                     false,
-                                     2160000000, 8316000000ULL,
-                                     WIFI_CODE_RATE_7_8,
-                                     64);
-  return mode;
+  return GetEdmgMcs (WIFI_MOD_CLASS_EDMG_OFDM, 20);
 }
 
 } //namespace ns3
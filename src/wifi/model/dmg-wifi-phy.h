@@ -309,6 +309,12 @@ public:
    * \param callback
    */
   void RegisterEndReceiveMimoTRNCallback (EndReceiveMimoTRNCallback callback);
+  /**
+   * Return the MAC address of the station whose PPDU (and any TRN field appended
+   * to it) we are currently synchronized to.
+   * \return The MAC address of the current sender.
+   */
+  Mac48Address GetCurrentSender (void) const;
   /**
    * Return the number of TRN Units appended to the last received packet
    * (Used when TRN aubfields are appended to the DMG beacons in the BHI)
@@ -118,7 +118,7 @@ Event::GetPayloadMode (void) const
   return m_txVector.GetMode ();
 }
 
-std::vector<double>
+const std::vector<double> &
 Event::GetMimoRxPowerW (void) const
 {
   return m_mimoRxPowerW;
@@ -126,29 +126,32 @@ Event::GetMimoRxPowerW (void) const
 
 std::vector<double>
 Event::GetMimoInterStreamInterference (void) const
+{
+  std::vector<double> interferenceList;
+  interferenceList.reserve (m_mimoRxPowerW.size ());
+  for (uint8_t location = 0; location < m_mimoRxPowerW.size (); location++)
+    {
+      interferenceList.push_back (GetMimoInterStreamInterference (location));
+    }
+  return interferenceList;
+}
+
+double
+Event::GetMimoInterStreamInterference (uint8_t location) const
 {
   uint8_t numTxAntennas = m_txVector.GetNumberOfTxChains ();
   uint8_t numRxAntennas = m_mimoRxPowerW.size ()/numTxAntennas;
-  double interference;
-  std::vector<double> interferenceList;
-  uint8_t index = 0;
-  for (uint8_t tx = 0; tx < numTxAntennas; tx++)
+  uint8_t tx = location / numRxAntennas;
+  uint8_t rx = location % numRxAntennas;
+  double interference = 0;
+  for (uint8_t txInterferer = 0; txInterferer < numTxAntennas; txInterferer++)
     {
-      for (uint8_t rx = 0; rx < numRxAntennas; rx++)
+      if (txInterferer != tx)
         {
-          interference = 0;
-          for (uint8_t txInterferer = 0; txInterferer < numTxAntennas; txInterferer++)
-            {
-              if (txInterferer != tx)
-                {
-                  interference += m_mimoRxPowerW.at (rx + txInterferer * numRxAntennas);
-                }
-            }
-          index++;
-          interferenceList.push_back (interference);
+          interference += m_mimoRxPowerW.at (rx + txInterferer * numRxAntennas);
         }
     }
-  return interferenceList;
+  return interference;
 }
 
 std::vector<uint8_t>
@@ -345,14 +348,17 @@ InterferenceHelper::AppendEvent (Ptr<Event> event)
     {
       m_firstPower = previousPowerStart;
       // Always leave the first zero power noise event in the list
-      m_niChanges.erase (++(m_niChanges.begin ()),
+      m_niChanges.erase (m_niChanges.begin () + 1,
                          GetNextPosition (event->GetStartTime ()));
     }
-  auto first = AddNiChangeEvent (event->GetStartTime (), NiChange (previousPowerStart, event));
-  auto last = AddNiChangeEvent (event->GetEndTime (), NiChange (previousPowerEnd, event));
-  for (auto i = first; i != last; ++i)
+  // Inserting a change may reallocate the list, so track the changes by index
+  auto it = AddNiChangeEvent (event->GetStartTime (), NiChange (previousPowerStart, event));
+  std::size_t first = it - m_niChanges.begin ();
+  it = AddNiChangeEvent (event->GetEndTime (), NiChange (previousPowerEnd, event));
+  std::size_t last = it - m_niChanges.begin ();
+  for (std::size_t i = first; i != last; ++i)
     {
-      i->second.AddPower (event->GetRxPowerW ());
+      m_niChanges[i].second.AddPower (event->GetRxPowerW ());
     }
 }
 
@@ -402,7 +408,8 @@ double
 InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const
 {
   double noiseInterferenceW = m_firstPower;
-  auto it = m_niChanges.find (event->GetStartTime ());
+  auto start = FindPosition (event->GetStartTime ());
+  auto it = start;
   for (; it != m_niChanges.end () && it->first < Simulator::Now (); ++it)
     {
       //// WIGIG ////
@@ -414,14 +421,20 @@ InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni
       //// WIGIG ////
       noiseInterferenceW = it->second.GetPower () - event->GetRxPowerW ();
     }
-  it = m_niChanges.find (event->GetStartTime ());
-  for (; it != m_niChanges.end () && it->second.GetEvent () != event; ++it);
-  ni->emplace (event->GetStartTime (), NiChange (0, event));
-  while (++it != m_niChanges.end () && it->second.GetEvent () != event)
+  for (it = start; it != m_niChanges.end () && it->second.GetEvent () != event; ++it);
+  /* The NiChanges between the start and the end of the event are already
+   * time-ordered, so they can be appended without any further sorting */
+  ni->clear ();
+  ni->reserve (m_niChanges.end () - it + 1);
+  ni->emplace_back (event->GetStartTime (), NiChange (0, event));
+  if (it != m_niChanges.end ())
     {
-      ni->insert (*it);
+      while (++it != m_niChanges.end () && it->second.GetEvent () != event)
+        {
+          ni->push_back (*it);
+        }
     }
-  ni->emplace (event->GetEndTime (), NiChange (0, event));
+  ni->emplace_back (event->GetEndTime (), NiChange (0, event));
   NS_ASSERT_MSG (noiseInterferenceW >= 0, "CalculateNoiseInterferenceW returns negative value " << noiseInterferenceW);
   return noiseInterferenceW;
 }
@@ -1057,14 +1070,15 @@ InterferenceHelper::CalculatePerStreamSnr (Ptr<Event const> event, double noiseI
       /* In case of MIMO calculate the SINR per stream taking into account inter-stream interference and
        * assuming that we try to decode the maximum received tx signal at each antenna as long as no two rx antennas
        * try to decode the same signal */
-      std::vector<double> mimoRxPowerW = event->GetMimoRxPowerW ();
-      std::vector<double> interStreamInterference = event->GetMimoInterStreamInterference ();
+      const std::vector<double> &mimoRxPowerW = event->GetMimoRxPowerW ();
+      const WifiTxVector txVector = event->GetTxVector ();
       std::vector<uint8_t> rxPowerLocations = event->GetMimoRxSignalLocation ();
+      perStreamSnr.reserve (rxPowerLocations.size ());
       for (auto rxStream : rxPowerLocations)
         {
           double snr = CalculateSnr (mimoRxPowerW.at (rxStream),
-                                     noiseInterferenceW + interStreamInterference.at (rxStream),
-                                     event->GetTxVector ());
+                                     noiseInterferenceW + event->GetMimoInterStreamInterference (rxStream),
+                                     txVector);
           perStreamSnr.push_back (snr);
         }
     }
@@ -1159,7 +1173,20 @@ InterferenceHelper::EraseEvents (void)
 InterferenceHelper::NiChanges::const_iterator
 InterferenceHelper::GetNextPosition (Time moment) const
 {
-  return m_niChanges.upper_bound (moment);
+  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), moment,
+                           [] (const Time &t, const NiChanges::value_type &change) { return t < change.first; });
+}
+
+InterferenceHelper::NiChanges::const_iterator
+InterferenceHelper::FindPosition (Time moment) const
+{
+  auto it = std::lower_bound (m_niChanges.begin (), m_niChanges.end (), moment,
+                              [] (const NiChanges::value_type &change, const Time &t) { return change.first < t; });
+  if (it != m_niChanges.end () && it->first != moment)
+    {
+      return m_niChanges.end ();
+    }
+  return it;
 }
 
 InterferenceHelper::NiChanges::const_iterator
@@ -24,6 +24,7 @@
 #include "ns3/nstime.h"
 #include "wifi-tx-vector.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -122,13 +123,20 @@ public:
    *
    * \return the list of received powers in the case of MIMO
    */
-  std::vector<double> GetMimoRxPowerW (void) const;
+  const std::vector<double> &GetMimoRxPowerW (void) const;
   /**
    * Return the list of inter-stream interference for each received MIMO power.
    *
    * \return the list of inter-stream interference values in the case of MIMO
    */
   std::vector<double> GetMimoInterStreamInterference (void) const;
+  /**
+   * Return the inter-stream interference (W) experienced by a single received MIMO power.
+   *
+   * \param location the index of the received power in the list of MIMO received powers
+   * \return the sum of the powers received at the same Rx antenna from the other Tx antennas
+   */
+  double GetMimoInterStreamInterference (uint8_t location) const;
   /**
    * Return the location of the Rx signals that we lock into for each Rx antenna
    * from the list of Rx powers in the case of MIMO.
@@ -446,9 +454,10 @@ private:
   };
 
   /**
-   * typedef for a multimap of NiChanges
+   * typedef for a time-ordered list of NiChanges. The list is kept sorted
+   * by time and NiChanges sharing the same time are kept in insertion order.
    */
-  typedef std::multimap<Time, NiChange> NiChanges;
+  typedef std::vector<std::pair<Time, NiChange> > NiChanges;
 
   /**
    * Append the given Event.
@@ -536,12 +545,12 @@ private:
    */
   NiChanges::const_iterator GetNextPosition (Time moment) const;
   /**
-   * Returns an iterator to the first NiChange that is later than moment
+   * Returns an iterator to the first NiChange that occurs at moment
    *
-   * \param moment time to check from
-   * \returns an iterator to the list of NiChanges
+   * \param moment time to look for
+   * \returns an iterator to the list of NiChanges, or the end of the list if none
    */
-  //NiChanges::iterator GetNextPosition (Time moment);
+  NiChanges::const_iterator FindPosition (Time moment) const;
   /**
    * Returns an iterator to the last NiChange that is before than moment
    *
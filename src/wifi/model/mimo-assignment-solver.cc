@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "mimo-assignment-solver.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MimoAssignmentSolver");
+
+MimoAssignmentSolver::MimoAssignmentSolver (uint8_t nTx, uint8_t nRx)
+  : m_nTx (nTx),
+    m_nRx (nRx),
+    m_snr (nTx * nRx, 0),
+    m_valid (nTx * nRx, false),
+    m_maxMinSnr (0)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint16_t> (nTx) << static_cast<uint16_t> (nRx));
+}
+
+void
+MimoAssignmentSolver::Clear (void)
+{
+  std::fill (m_valid.begin (), m_valid.end (), false);
+  m_assignment.clear ();
+}
+
+void
+MimoAssignmentSolver::SetSnr (uint8_t txIdx, uint8_t rxIdx, double snr)
+{
+  NS_ASSERT (txIdx < m_nTx && rxIdx < m_nRx);
+  m_snr[txIdx * m_nRx + rxIdx] = snr;
+  m_valid[txIdx * m_nRx + rxIdx] = true;
+}
+
+double
+MimoAssignmentSolver::GetUpperBound (uint8_t nStreams) const
+{
+  if (nStreams == 0)
+    return std::numeric_limits<double>::max ();
+  /* Every stream uses a different Tx and a different Rx antenna, so the minimum per-stream SNR can not be higher
+   * than the nStreams-th highest of the best SNRs of the Tx antennas, and the same holds for the Rx antennas. */
+  m_txBest.clear ();
+  m_rxBest.clear ();
+  for (uint8_t tx = 0; tx < m_nTx; tx++)
+    {
+      bool found = false;
+      double best = 0;
+      for (uint8_t rx = 0; rx < m_nRx; rx++)
+        {
+          uint16_t idx = tx * m_nRx + rx;
+          if (m_valid[idx] && (!found || m_snr[idx] > best))
+            {
+              best = m_snr[idx];
+              found = true;
+            }
+        }
+      if (found)
+        m_txBest.push_back (best);
+    }
+  for (uint8_t rx = 0; rx < m_nRx; rx++)
+    {
+      bool found = false;
+      double best = 0;
+      for (uint8_t tx = 0; tx < m_nTx; tx++)
+        {
+          uint16_t idx = tx * m_nRx + rx;
+          if (m_valid[idx] && (!found || m_snr[idx] > best))
+            {
+              best = m_snr[idx];
+              found = true;
+            }
+        }
+      if (found)
+        m_rxBest.push_back (best);
+    }
+  if (m_txBest.size () < nStreams || m_rxBest.size () < nStreams)
+    return std::numeric_limits<double>::lowest ();
+  std::nth_element (m_txBest.begin (), m_txBest.begin () + nStreams - 1, m_txBest.end (), std::greater<double> ());
+  std::nth_element (m_rxBest.begin (), m_rxBest.begin () + nStreams - 1, m_rxBest.end (), std::greater<double> ());
+  return std::min (m_txBest[nStreams - 1], m_rxBest[nStreams - 1]);
+}
+
+bool
+MimoAssignmentSolver::Solve (uint8_t nStreams)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint16_t> (nStreams));
+  m_assignment.clear ();
+  if (nStreams == 0 || nStreams > m_nTx || nStreams > m_nRx)
+    return false;
+
+  /* The minimum per-stream SNR of the optimal assignment is one of the measured SNRs - look for the highest one
+   * for which an assignment using only Tx-Rx pairs with at least that SNR exists. The search is limited to the SNRs
+   * below the upper bound, since no assignment can do better than that. */
+  double upperBound = GetUpperBound (nStreams);
+  m_thresholds.clear ();
+  for (uint16_t idx = 0; idx < m_snr.size (); idx++)
+    {
+      if (m_valid[idx] && m_snr[idx] <= upperBound)
+        m_thresholds.push_back (m_snr[idx]);
+    }
+  std::sort (m_thresholds.begin (), m_thresholds.end ());
+  m_thresholds.erase (std::unique (m_thresholds.begin (), m_thresholds.end ()), m_thresholds.end ());
+  std::vector<bool> usedRx (m_nRx, false);
+  if (m_thresholds.empty () || GetMatchingSize (m_thresholds.front (), 0, usedRx) < nStreams)
+    return false;
+  uint16_t low = 0;
+  uint16_t high = m_thresholds.size () - 1;
+  while (low < high)
+    {
+      uint16_t mid = (low + high + 1) / 2;
+      if (GetMatchingSize (m_thresholds[mid], 0, usedRx) >= nStreams)
+        low = mid;
+      else
+        high = mid - 1;
+    }
+  double threshold = m_thresholds[low];
+
+  /* Build the optimal assignment with the smallest Tx-Rx pair indexes, picking for each stream the first pair
+   * above the threshold that still allows the remaining streams to be assigned. */
+  uint8_t firstTx = 0;
+  for (uint8_t stream = 0; stream < nStreams; stream++)
+    {
+      uint8_t remainingStreams = nStreams - stream - 1;
+      bool found = false;
+      for (uint8_t tx = firstTx; tx < m_nTx && !found; tx++)
+        {
+          for (uint8_t rx = 0; rx < m_nRx; rx++)
+            {
+              uint16_t idx = tx * m_nRx + rx;
+              if (!m_valid[idx] || usedRx[rx] || m_snr[idx] < threshold)
+                continue;
+              usedRx[rx] = true;
+              if (remainingStreams == 0 || GetMatchingSize (threshold, tx + 1, usedRx) >= remainingStreams)
+                {
+                  m_assignment.push_back (idx);
+                  firstTx = tx + 1;
+                  found = true;
+                  break;
+                }
+              usedRx[rx] = false;
+            }
+        }
+      NS_ASSERT_MSG (found, "Failed to build an assignment above the feasible threshold");
+    }
+  m_maxMinSnr = threshold;
+  return true;
+}
+
+double
+MimoAssignmentSolver::GetMaxMinSnr (void) const
+{
+  return m_maxMinSnr;
+}
+
+const std::vector<uint16_t> &
+MimoAssignmentSolver::GetAssignment (void) const
+{
+  return m_assignment;
+}
+
+uint8_t
+MimoAssignmentSolver::GetMatchingSize (double threshold, uint8_t firstTx, const std::vector<bool> &usedRx) const
+{
+  m_rxMatch.assign (m_nRx, -1);
+  uint8_t matchingSize = 0;
+  for (uint8_t tx = firstTx; tx < m_nTx; tx++)
+    {
+      m_visited.assign (m_nRx, false);
+      if (Augment (tx, threshold, usedRx))
+        matchingSize++;
+    }
+  return matchingSize;
+}
+
+bool
+MimoAssignmentSolver::Augment (uint8_t txIdx, double threshold, const std::vector<bool> &usedRx) const
+{
+  for (uint8_t rx = 0; rx < m_nRx; rx++)
+    {
+      uint16_t idx = txIdx * m_nRx + rx;
+      if (usedRx[rx] || m_visited[rx] || !m_valid[idx] || m_snr[idx] < threshold)
+        continue;
+      m_visited[rx] = true;
+      if (m_rxMatch[rx] < 0 || Augment (m_rxMatch[rx], threshold, usedRx))
+        {
+          m_rxMatch[rx] = txIdx;
+          return true;
+        }
+    }
+  return false;
+}
+
+} // namespace ns3
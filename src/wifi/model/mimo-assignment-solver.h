@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MIMO_ASSIGNMENT_SOLVER_H
+#define MIMO_ASSIGNMENT_SOLVER_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Max-min assignment of Tx antennas to Rx antennas for MIMO beamforming training.
+ * \ingroup wifi
+ *
+ * Given the SNR measured between every Tx antenna and every Rx antenna (or responder STA in MU-MIMO),
+ * find the assignment of nStreams Tx-Rx pairs, no two of which share a Tx or an Rx antenna, that maximizes
+ * the minimum per-stream SNR. Instead of checking every valid combination of Tx-Rx pairs, the solver looks
+ * for the highest SNR threshold for which a complete assignment exists, using augmenting paths to check
+ * whether the Tx-Rx pairs above the threshold contain a matching of the required size.
+ *
+ * A Tx-Rx pair is identified by the index txIdx * nRx + rxIdx. Among all optimal assignments the solver
+ * returns the one whose sorted list of indexes is the lexicographically smallest, i.e. the first one that
+ * DmgWifiMac::FindAllValidTxRxPairs would have listed.
+ */
+class MimoAssignmentSolver
+{
+public:
+  /**
+   * Create a solver for the given number of Tx and Rx antennas with no Tx-Rx pairs set.
+   * \param nTx The number of Tx antennas.
+   * \param nRx The number of Rx antennas.
+   */
+  MimoAssignmentSolver (uint8_t nTx, uint8_t nRx);
+  /**
+   * Remove all Tx-Rx pairs set so far.
+   */
+  void Clear (void);
+  /**
+   * Set the SNR of a Tx-Rx pair. Pairs that are never set can not be part of an assignment.
+   * \param txIdx The index of the Tx antenna.
+   * \param rxIdx The index of the Rx antenna.
+   * \param snr The SNR measured between the two antennas.
+   */
+  void SetSnr (uint8_t txIdx, uint8_t rxIdx, double snr);
+  /**
+   * Get an upper bound on the minimum per-stream SNR of any assignment with the given number of streams.
+   * The bound is cheap to compute and can be used to skip solving for candidates that can not improve on the best
+   * assignment found so far.
+   * \param nStreams The number of streams.
+   * \return The upper bound.
+   */
+  double GetUpperBound (uint8_t nStreams) const;
+  /**
+   * Find the assignment with the given number of streams that maximizes the minimum per-stream SNR.
+   * \param nStreams The number of streams.
+   * \return True if an assignment exists, false otherwise.
+   */
+  bool Solve (uint8_t nStreams);
+  /**
+   * \return The minimum per-stream SNR of the assignment found by the last call to Solve.
+   */
+  double GetMaxMinSnr (void) const;
+  /**
+   * \return The indexes of the Tx-Rx pairs of the assignment found by the last call to Solve, in ascending order.
+   */
+  const std::vector<uint16_t> &GetAssignment (void) const;
+
+private:
+  /**
+   * Find the size of the maximum matching between the Tx antennas starting from the given one and the Rx antennas
+   * not yet used, using only Tx-Rx pairs with an SNR of at least the given threshold.
+   * \param threshold The SNR threshold.
+   * \param firstTx The index of the first Tx antenna that can be used.
+   * \param usedRx The Rx antennas that can not be used.
+   * \return The size of the matching.
+   */
+  uint8_t GetMatchingSize (double threshold, uint8_t firstTx, const std::vector<bool> &usedRx) const;
+  /**
+   * Try to find an augmenting path starting from the given Tx antenna.
+   * \param txIdx The index of the Tx antenna.
+   * \param threshold The SNR threshold.
+   * \param usedRx The Rx antennas that can not be used.
+   * \return True if the matching has been augmented, false otherwise.
+   */
+  bool Augment (uint8_t txIdx, double threshold, const std::vector<bool> &usedRx) const;
+
+  uint8_t m_nTx;                        //!< The number of Tx antennas.
+  uint8_t m_nRx;                        //!< The number of Rx antennas.
+  std::vector<double> m_snr;            //!< The SNR of each Tx-Rx pair.
+  std::vector<bool> m_valid;            //!< Whether each Tx-Rx pair has been set.
+  double m_maxMinSnr;                   //!< The minimum per-stream SNR of the last assignment.
+  std::vector<uint16_t> m_assignment;   //!< The Tx-Rx pairs of the last assignment.
+  std::vector<double> m_thresholds;     //!< Scratch list of the candidate SNR thresholds.
+  mutable std::vector<double> m_txBest; //!< Scratch list of the best SNR of each Tx antenna.
+  mutable std::vector<double> m_rxBest; //!< Scratch list of the best SNR of each Rx antenna.
+  mutable std::vector<int> m_rxMatch;   //!< Scratch list of the Tx antenna matched to each Rx antenna.
+  mutable std::vector<bool> m_visited;  //!< Scratch list of the Rx antennas visited by an augmenting path.
+
+};
+
+} // namespace ns3
+
+#endif /* MIMO_ASSIGNMENT_SOLVER_H */
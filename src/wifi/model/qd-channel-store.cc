@@ -0,0 +1,449 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015-2020 IMDEA Networks Institute
+ * Copyright (c) 2018-2020 National Institute of Standards and Technology (NIST)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/system-path.h"
+#include "qd-channel-store.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("QdChannelStore");
+
+namespace {
+
+const char QD_BINARY_MAGIC[4] = {'Q', 'D', 'C', 'B'};
+const uint32_t QD_BINARY_VERSION = 2;
+const uint32_t QD_BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * Header of a binary Q-D file.
+ */
+struct QdFileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t numRecords;
+  uint32_t byteOrderMark;
+  uint64_t sourceSize;          //!< Size of the Q-D text file the binary file was converted from.
+  int64_t sourceModTime;        //!< Modification time (seconds since the epoch) of the Q-D text file.
+};
+
+/**
+ * Get the size and the modification time of a file.
+ * \param fileName The path to the file.
+ * \param size The size of the file in bytes.
+ * \param modTime The modification time of the file in seconds since the epoch.
+ * \return True if the file exists, otherwise false.
+ */
+bool
+GetFileStamp (const std::string &fileName, uint64_t &size, int64_t &modTime)
+{
+  struct stat fileStat;
+  if (stat (fileName.c_str (), &fileStat) != 0)
+    {
+      return false;
+    }
+  size = fileStat.st_size;
+  modTime = fileStat.st_mtime;
+  return true;
+}
+
+/**
+ * Entry of the index table of a binary Q-D file.
+ */
+struct QdFileIndexEntry {
+  uint64_t offset;              //!< Offset of the record data from the start of the file.
+  uint32_t numPaths;            //!< The number of multipath components in the record.
+  uint32_t reserved;
+};
+
+/**
+ * Parse a line of comma separated values.
+ * \param line The line to parse.
+ * \param values The vector to fill with the parsed values.
+ */
+void
+ParseCommaSeparatedLine (const std::string &line, std::vector<float> &values)
+{
+  const char *cursor = line.c_str ();
+  const char *end = cursor + line.size ();
+  while (cursor < end)
+    {
+      char *next;
+      float value = std::strtof (cursor, &next);
+      if (next == cursor)
+        {
+          /* Empty or malformed token, keep the same behavior as the text parser */
+          value = 0;
+        }
+      values.push_back (value);
+      cursor = static_cast<const char *> (std::memchr (next, ',', end - next));
+      if (cursor == 0)
+        {
+          break;
+        }
+      cursor++;
+    }
+}
+
+} // anonymous namespace
+
+QdChannelStore::QdChannelStore ()
+  : m_data (0),
+    m_size (0),
+    m_mapped (false),
+    m_numRecords (0),
+    m_numTxAntennas (0),
+    m_numRxAntennas (0)
+{
+}
+
+QdChannelStore::~QdChannelStore ()
+{
+  Close ();
+}
+
+bool
+QdChannelStore::Open (const std::string &fileName, uint8_t numTxAntennas, uint8_t numRxAntennas)
+{
+  NS_LOG_FUNCTION (this << fileName << +numTxAntennas << +numRxAntennas);
+  Close ();
+
+  int fd = open (fileName.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      return false;
+    }
+  struct stat fileStat;
+  if ((fstat (fd, &fileStat) != 0) || (fileStat.st_size == 0))
+    {
+      close (fd);
+      NS_LOG_ERROR ("Invalid binary Q-D file: " << fileName);
+      return false;
+    }
+  size_t size = fileStat.st_size;
+  void *data = mmap (0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      NS_LOG_ERROR ("Cannot map binary Q-D file: " << fileName);
+      return false;
+    }
+  if (!Attach (static_cast<const uint8_t *> (data), size, numTxAntennas, numRxAntennas))
+    {
+      munmap (data, size);
+      NS_LOG_ERROR ("Corrupted or incompatible binary Q-D file: " << fileName);
+      return false;
+    }
+  m_mapped = true;
+  NS_LOG_INFO ("Mapped binary Q-D file " << fileName << " with " << m_numRecords << " records");
+  return true;
+}
+
+bool
+QdChannelStore::Open (const std::string &fileName, const std::string &textFile,
+                      uint8_t numTxAntennas, uint8_t numRxAntennas)
+{
+  NS_LOG_FUNCTION (this << fileName << textFile << +numTxAntennas << +numRxAntennas);
+  if (!Open (fileName, numTxAntennas, numRxAntennas))
+    {
+      return false;
+    }
+  uint64_t size;
+  int64_t modTime;
+  if (GetFileStamp (textFile, size, modTime))
+    {
+      const QdFileHeader *header = reinterpret_cast<const QdFileHeader *> (m_data);
+      if ((header->sourceSize != size) || (header->sourceModTime != modTime))
+        {
+          NS_LOG_WARN ("Binary Q-D file " << fileName << " is older than " << textFile << ", ignore it");
+          Close ();
+          return false;
+        }
+    }
+  return true;
+}
+
+bool
+QdChannelStore::LoadTextFile (const std::string &fileName, uint8_t numTxAntennas, uint8_t numRxAntennas)
+{
+  NS_LOG_FUNCTION (this << fileName << +numTxAntennas << +numRxAntennas);
+  Close ();
+  if (!ParseTextFile (fileName, m_buffer))
+    {
+      return false;
+    }
+  bool attached = Attach (&m_buffer[0], m_buffer.size (), numTxAntennas, numRxAntennas);
+  NS_ASSERT (attached);
+  return attached;
+}
+
+bool
+QdChannelStore::Attach (const uint8_t *data, size_t size, uint8_t numTxAntennas, uint8_t numRxAntennas)
+{
+  NS_ASSERT ((numTxAntennas > 0) && (numRxAntennas > 0));
+  if (size < sizeof (QdFileHeader))
+    {
+      return false;
+    }
+
+  /* Validate the header and the index table before exposing any record */
+  const QdFileHeader *header = reinterpret_cast<const QdFileHeader *> (data);
+  bool valid = (std::memcmp (header->magic, QD_BINARY_MAGIC, sizeof (QD_BINARY_MAGIC)) == 0)
+    && (header->version == QD_BINARY_VERSION)
+    && (header->byteOrderMark == QD_BYTE_ORDER_MARK)
+    && (sizeof (QdFileHeader) + uint64_t (header->numRecords) * sizeof (QdFileIndexEntry) <= size);
+  if (valid)
+    {
+      const QdFileIndexEntry *index = reinterpret_cast<const QdFileIndexEntry *> (data + sizeof (QdFileHeader));
+      for (uint32_t i = 0; valid && (i < header->numRecords); i++)
+        {
+          uint64_t length = uint64_t (index[i].numPaths) * QD_NUM_PATH_PARAMETERS * sizeof (float);
+          valid = (index[i].offset % sizeof (float) == 0) && (index[i].offset + length <= size);
+        }
+    }
+  if (!valid)
+    {
+      return false;
+    }
+
+  m_data = data;
+  m_size = size;
+  m_numRecords = header->numRecords;
+  m_numTxAntennas = numTxAntennas;
+  m_numRxAntennas = numRxAntennas;
+  return true;
+}
+
+void
+QdChannelStore::Close (void)
+{
+  if (m_mapped)
+    {
+      munmap (const_cast<uint8_t *> (m_data), m_size);
+      m_mapped = false;
+    }
+  m_buffer.clear ();
+  m_data = 0;
+  m_size = 0;
+  m_numRecords = 0;
+}
+
+bool
+QdChannelStore::IsOpen (void) const
+{
+  return (m_data != 0);
+}
+
+uint32_t
+QdChannelStore::GetNumTraces (void) const
+{
+  return m_numRecords / (uint32_t (m_numTxAntennas) * m_numRxAntennas);
+}
+
+uint32_t
+QdChannelStore::GetNumRecords (void) const
+{
+  return m_numRecords;
+}
+
+QdChannelRecord
+QdChannelStore::GetRecord (uint32_t traceIndex, AntennaID txAntenna, AntennaID rxAntenna) const
+{
+  NS_ASSERT ((txAntenna >= 1) && (txAntenna <= m_numTxAntennas));
+  NS_ASSERT ((rxAntenna >= 1) && (rxAntenna <= m_numRxAntennas));
+  uint32_t recordIndex = (traceIndex * m_numTxAntennas + (txAntenna - 1)) * m_numRxAntennas + (rxAntenna - 1);
+  return GetRecord (recordIndex);
+}
+
+QdChannelRecord
+QdChannelStore::GetRecord (uint32_t recordIndex) const
+{
+  NS_ASSERT_MSG (recordIndex < m_numRecords, "Record " << recordIndex << " is outside the Q-D file");
+  const QdFileIndexEntry *entry =
+    reinterpret_cast<const QdFileIndexEntry *> (m_data + sizeof (QdFileHeader)) + recordIndex;
+  const float *values = reinterpret_cast<const float *> (m_data + entry->offset);
+  QdChannelRecord record;
+  record.numPaths = entry->numPaths;
+  record.delay = values;
+  record.pathLoss = values + entry->numPaths;
+  record.phase = values + 2 * entry->numPaths;
+  record.aodElevation = values + 3 * entry->numPaths;
+  record.aodAzimuth = values + 4 * entry->numPaths;
+  record.aoaElevation = values + 5 * entry->numPaths;
+  record.aoaAzimuth = values + 6 * entry->numPaths;
+  return record;
+}
+
+std::string
+QdChannelStore::GetBinaryFileName (const std::string &textFile)
+{
+  std::string::size_type pos = textFile.rfind (".txt");
+  if (pos != std::string::npos && pos + 4 == textFile.size ())
+    {
+      return textFile.substr (0, pos) + ".bin";
+    }
+  return textFile + ".bin";
+}
+
+bool
+QdChannelStore::ParseTextFile (const std::string &textFile, std::vector<uint8_t> &image)
+{
+  NS_LOG_FUNCTION (textFile);
+  uint64_t sourceSize;
+  int64_t sourceModTime;
+  std::ifstream qdFile (textFile.c_str (), std::ifstream::in);
+  if (!qdFile.good () || !GetFileStamp (textFile, sourceSize, sourceModTime))
+    {
+      NS_LOG_ERROR ("Error Opening Q-D Channel Model File: " << textFile);
+      return false;
+    }
+
+  /* Parse the text file record by record, a record with no multipath has a single line */
+  std::vector<uint32_t> numPathsList;
+  std::vector<float> data;
+  std::vector<float> values;
+  std::string line;
+  while (true)
+    {
+      std::getline (qdFile, line);
+      if (qdFile.eof ())
+        {
+          break;
+        }
+      uint32_t numPaths = std::stoul (line);
+      size_t recordStart = data.size ();
+      bool complete = true;
+      for (uint16_t parameterNumber = 1; (numPaths > 0) && (parameterNumber <= QD_NUM_PATH_PARAMETERS); parameterNumber++)
+        {
+          std::getline (qdFile, line);
+          if (qdFile.eof ())
+            {
+              complete = false;
+              break;
+            }
+          values.clear ();
+          ParseCommaSeparatedLine (line, values);
+          if (values.size () != numPaths)
+            {
+              NS_LOG_ERROR ("Malformed Q-D Channel Model File: " << textFile << ", expected " << numPaths
+                            << " values but found " << values.size ());
+              return false;
+            }
+          data.insert (data.end (), values.begin (), values.end ());
+        }
+      if (!complete)
+        {
+          /* Drop the truncated record */
+          data.resize (recordStart);
+          break;
+        }
+      numPathsList.push_back (numPaths);
+    }
+  qdFile.close ();
+
+  /* Build the header, the index table and the data in their final layout */
+  size_t dataOffset = sizeof (QdFileHeader) + numPathsList.size () * sizeof (QdFileIndexEntry);
+  image.assign (dataOffset + data.size () * sizeof (float), 0);
+
+  QdFileHeader *header = reinterpret_cast<QdFileHeader *> (&image[0]);
+  std::memcpy (header->magic, QD_BINARY_MAGIC, sizeof (QD_BINARY_MAGIC));
+  header->version = QD_BINARY_VERSION;
+  header->numRecords = numPathsList.size ();
+  header->byteOrderMark = QD_BYTE_ORDER_MARK;
+  header->sourceSize = sourceSize;
+  header->sourceModTime = sourceModTime;
+
+  QdFileIndexEntry *index = reinterpret_cast<QdFileIndexEntry *> (&image[0] + sizeof (QdFileHeader));
+  uint64_t offset = dataOffset;
+  for (size_t i = 0; i < numPathsList.size (); i++)
+    {
+      index[i].offset = offset;
+      index[i].numPaths = numPathsList[i];
+      index[i].reserved = 0;
+      offset += uint64_t (numPathsList[i]) * QD_NUM_PATH_PARAMETERS * sizeof (float);
+    }
+  if (!data.empty ())
+    {
+      std::memcpy (&image[dataOffset], &data[0], data.size () * sizeof (float));
+    }
+  return true;
+}
+
+bool
+QdChannelStore::ConvertTextFile (const std::string &textFile, const std::string &binaryFile)
+{
+  NS_LOG_FUNCTION (textFile << binaryFile);
+  std::vector<uint8_t> image;
+  if (!ParseTextFile (textFile, image))
+    {
+      return false;
+    }
+  std::ofstream binFile (binaryFile.c_str (), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+  if (!binFile.good ())
+    {
+      NS_LOG_ERROR ("Error Creating binary Q-D file: " << binaryFile);
+      return false;
+    }
+  binFile.write (reinterpret_cast<const char *> (&image[0]), image.size ());
+  binFile.close ();
+  if (binFile.fail ())
+    {
+      NS_LOG_ERROR ("Error Writing binary Q-D file: " << binaryFile);
+      return false;
+    }
+  NS_LOG_INFO ("Converted " << textFile << " into " << binaryFile);
+  return true;
+}
+
+uint32_t
+QdChannelStore::ConvertFolder (const std::string &qdFolder)
+{
+  NS_LOG_FUNCTION (qdFolder);
+  std::string qdFilesFolder = qdFolder + "QdFiles";
+  std::list<std::string> files = SystemPath::ReadFiles (qdFilesFolder);
+  uint32_t converted = 0;
+  for (std::list<std::string>::const_iterator it = files.begin (); it != files.end (); it++)
+    {
+      const std::string &name = *it;
+      if ((name.compare (0, 2, "Tx") != 0) || (name.size () < 4) || (name.compare (name.size () - 4, 4, ".txt") != 0))
+        {
+          continue;
+        }
+      std::string textFile = qdFilesFolder + "/" + name;
+      if (ConvertTextFile (textFile, GetBinaryFileName (textFile)))
+        {
+          converted++;
+        }
+    }
+  return converted;
+}
+
+} // namespace ns3
@@ -0,0 +1,191 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015-2020 IMDEA Networks Institute
+ * Copyright (c) 2018-2020 National Institute of Standards and Technology (NIST)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QD_CHANNEL_STORE_H
+#define QD_CHANNEL_STORE_H
+
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "wigig-data-types.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * The number of per-path parameters stored for each Q-D channel realization
+ * (delay, path gain, phase, AoD elevation, AoD azimuth, AoA elevation, AoA azimuth).
+ */
+#define QD_NUM_PATH_PARAMETERS  7
+
+/**
+ * Read-only view over the multipath parameters of a single Q-D channel realization,
+ * i.e., one trace index between one Tx antenna and one Rx antenna. The pointers
+ * reference the Q-D file image directly and remain valid as long as the
+ * QdChannelStore that returned them is alive.
+ */
+struct QdChannelRecord {
+  uint32_t numPaths;            //!< The number of multipath components.
+  const float *delay;           //!< Delay of each multipath component in seconds.
+  const float *pathLoss;        //!< Path gain in dB.
+  const float *phase;           //!< Phase in radians.
+  const float *aodElevation;    //!< AoD elevation in degrees (Q-D coordinate system).
+  const float *aodAzimuth;      //!< AoD azimuth in degrees (Q-D coordinate system).
+  const float *aoaElevation;    //!< AoA elevation in degrees (Q-D coordinate system).
+  const float *aoaAzimuth;      //!< AoA azimuth in degrees (Q-D coordinate system).
+};
+
+/**
+ * \brief Binary, memory-mapped store for the Q-D channel between one pair of nodes.
+ *
+ * The binary Q-D format holds exactly the same records as the text files generated
+ * by the Q-D realization software (Tx<i>Rx<j>.txt), in the same order, but each
+ * record is stored as a structure of arrays of native floats and is located through
+ * a fixed-size index table. Opening a file maps it in memory, so records are accessed
+ * without parsing or copying.
+ *
+ * Layout of a binary Q-D file (native byte order):
+ * - Header: magic "QDCB", format version, number of records, byte order mark, size and
+ *   modification time of the source text file.
+ * - Index: one entry per record holding the byte offset of its data and its number of paths.
+ * - Data: for each record, QD_NUM_PATH_PARAMETERS consecutive arrays of numPaths floats.
+ *
+ * Records are ordered by trace index, then Tx antenna, then Rx antenna.
+ */
+class QdChannelStore : public SimpleRefCount<QdChannelStore>
+{
+public:
+  QdChannelStore ();
+  ~QdChannelStore ();
+
+  /**
+   * Map a binary Q-D file in memory.
+   * \param fileName The path to the binary Q-D file.
+   * \param numTxAntennas The number of phased antenna arrays of the transmitter.
+   * \param numRxAntennas The number of phased antenna arrays of the receiver.
+   * \return True if the file has been mapped and validated successfully, otherwise false.
+   */
+  bool Open (const std::string &fileName, uint8_t numTxAntennas, uint8_t numRxAntennas);
+  /**
+   * Map a binary Q-D file in memory if it is up to date with the Q-D text file it was converted from.
+   * The binary file is stale, and rejected, if the size or the modification time of the text file differ
+   * from the ones recorded during the conversion. If the text file does not exist, the binary file is used as it is.
+   * \param fileName The path to the binary Q-D file.
+   * \param textFile The path to the Q-D text file the binary file was converted from.
+   * \param numTxAntennas The number of phased antenna arrays of the transmitter.
+   * \param numRxAntennas The number of phased antenna arrays of the receiver.
+   * \return True if the file has been mapped and validated successfully, otherwise false.
+   */
+  bool Open (const std::string &fileName, const std::string &textFile, uint8_t numTxAntennas, uint8_t numRxAntennas);
+  /**
+   * Parse a Q-D text file and keep its records in memory using the binary layout.
+   * \param fileName The path to the Q-D text file.
+   * \param numTxAntennas The number of phased antenna arrays of the transmitter.
+   * \param numRxAntennas The number of phased antenna arrays of the receiver.
+   * \return True if the file has been parsed successfully, otherwise false.
+   */
+  bool LoadTextFile (const std::string &fileName, uint8_t numTxAntennas, uint8_t numRxAntennas);
+  /**
+   * Unmap the binary Q-D file or release the parsed text file.
+   */
+  void Close (void);
+  /**
+   * \return True if a Q-D file is currently mapped or loaded.
+   */
+  bool IsOpen (void) const;
+  /**
+   * \return The number of complete traces in the Q-D file.
+   */
+  uint32_t GetNumTraces (void) const;
+  /**
+   * \return The total number of records in the Q-D file.
+   */
+  uint32_t GetNumRecords (void) const;
+  /**
+   * Get the multipath parameters of a Q-D channel realization.
+   * \param traceIndex The index of the trace in the Q-D file.
+   * \param txAntenna The ID of the transmit antenna (starting from 1).
+   * \param rxAntenna The ID of the receive antenna (starting from 1).
+   * \return A view over the multipath parameters of the requested channel.
+   */
+  QdChannelRecord GetRecord (uint32_t traceIndex, AntennaID txAntenna, AntennaID rxAntenna) const;
+
+  /**
+   * Convert a Q-D text file into the binary Q-D format.
+   * \param textFile The path to the Q-D text file.
+   * \param binaryFile The path to the binary Q-D file to create.
+   * \return True if the conversion succeeded, otherwise false.
+   */
+  static bool ConvertTextFile (const std::string &textFile, const std::string &binaryFile);
+  /**
+   * Convert all the Q-D text files (QdFiles/Tx<i>Rx<j>.txt) of a Q-D channel folder
+   * into binary Q-D files stored next to them.
+   * \param qdFolder The path to the Q-D channel folder (as given to QdPropagationEngine).
+   * \return The number of converted files.
+   */
+  static uint32_t ConvertFolder (const std::string &qdFolder);
+  /**
+   * Get the name of the binary Q-D file corresponding to a Q-D text file.
+   * \param textFile The path to the Q-D text file.
+   * \return The path to the binary Q-D file.
+   */
+  static std::string GetBinaryFileName (const std::string &textFile);
+
+private:
+  /**
+   * Parse a Q-D text file into a binary Q-D file image.
+   * \param textFile The path to the Q-D text file.
+   * \param image The buffer to fill with the binary Q-D file image.
+   * \return True if the file has been parsed successfully, otherwise false.
+   */
+  static bool ParseTextFile (const std::string &textFile, std::vector<uint8_t> &image);
+  /**
+   * Validate a binary Q-D file image and use it as the content of this store.
+   * \param data Pointer to the start of the binary Q-D file image.
+   * \param size The size of the image in bytes.
+   * \param numTxAntennas The number of phased antenna arrays of the transmitter.
+   * \param numRxAntennas The number of phased antenna arrays of the receiver.
+   * \return True if the image is valid, otherwise false.
+   */
+  bool Attach (const uint8_t *data, size_t size, uint8_t numTxAntennas, uint8_t numRxAntennas);
+  /**
+   * Get the multipath parameters of a record.
+   * \param recordIndex The index of the record in the Q-D file.
+   * \return A view over the multipath parameters of the record.
+   */
+  QdChannelRecord GetRecord (uint32_t recordIndex) const;
+
+  /* Copying a store would unmap the file twice */
+  QdChannelStore (const QdChannelStore &);
+  QdChannelStore & operator = (const QdChannelStore &);
+
+  const uint8_t *m_data;        //!< Start of the binary Q-D file image.
+  size_t m_size;                //!< Size of the binary Q-D file image in bytes.
+  bool m_mapped;                //!< Flag to indicate whether the image is a memory-mapped file.
+  std::vector<uint8_t> m_buffer;//!< Image built from a Q-D text file.
+  uint32_t m_numRecords;        //!< The number of records in the file.
+  uint8_t m_numTxAntennas;      //!< The number of Tx antennas.
+  uint8_t m_numRxAntennas;      //!< The number of Rx antennas.
+
+};
+
+} // namespace ns3
+
+#endif /* QD_CHANNEL_STORE_H */
@@ -42,7 +42,9 @@
 #include "wifi-net-device.h"
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <sstream>
 #include <string>
 
 namespace ns3 {
@@ -78,11 +80,41 @@ QdPropagationEngine::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&QdPropagationEngine::m_useCustomIDs),
                    MakeBooleanChecker ())
+    .AddAttribute ("ChannelGainCacheSize",
+                   "The maximum number of channel gains kept in the cache, the least recently used "
+                   "ones are evicted first. A value of zero means that the cache is unbounded.",
+                   UintegerValue (16384),
+                   MakeUintegerAccessor (&QdPropagationEngine::m_channelGainCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("ChannelGainCacheHits",
+                   "The number of channel gains served from the cache.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&QdPropagationEngine::m_channelGainCacheHits),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("ChannelGainCacheMisses",
+                   "The number of channel gains computed because they were missing from the cache "
+                   "or were computed for a different Q-D channel realization.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&QdPropagationEngine::m_channelGainCacheMisses),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("Prefetch",
+                   "Flag to indicate whether the channel gains of the links used during the previous "
+                   "trace are computed for the next trace in a worker thread. The prefetched gains "
+                   "are applied when the links are first used in the next trace and are identical to "
+                   "the ones computed on demand. Only relevant with a positive Interval.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&QdPropagationEngine::m_prefetch),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 QdPropagationEngine::QdPropagationEngine ()
+  : m_channelGainCacheHits (0),
+    m_channelGainCacheMisses (0),
+    m_nextGeneration (1)
 {
   NS_LOG_FUNCTION (this);
   m_uniformRv = CreateObject<UniformRandomVariable> ();
@@ -97,7 +129,20 @@ void
 QdPropagationEngine::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_prefetchThread != 0)
+    {
+      m_prefetchThread->Join ();
+      m_prefetchThread = 0;
+    }
+#endif
+  m_prefetchJob = 0;
   m_uniformRv = 0;
+  m_channelGainMatrix.clear ();
+  m_channelGainLru.clear ();
+  m_channelPairs.clear ();
+  m_rotationMatrices.clear ();
+  m_deviceHandles.clear ();
 }
 
 void
@@ -121,35 +166,43 @@ QdPropagationEngine::GetCurrentTraceIndex (void) const
   return m_currentIndex;
 }
 
+/**
+ * Check whether two Q-D channel realizations have identical multipath parameters.
+ * \param a The first channel realization.
+ * \param b The second channel realization.
+ * \return True if both realizations have the same multipath parameters.
+ */
+static bool
+IdenticalChannels (const QdChannelParameters &a, const QdChannelParameters &b)
+{
+  size_t size = a.numPaths * sizeof (float);
+  return (a.numPaths == b.numPaths)
+    && (memcmp (a.delay, b.delay, size) == 0)
+    && (memcmp (a.pathLoss, b.pathLoss, size) == 0)
+    && (memcmp (a.phase, b.phase, size) == 0)
+    && (a.angles == b.angles);
+}
+
 void
-QdPropagationEngine::InitializeQDModelParameters (Ptr<const MobilityModel> txMobility, Ptr<const MobilityModel> rxMobility,
+QdPropagationEngine::InitializeQDModelParameters (const QdDeviceHandle &tx, const QdDeviceHandle &rx,
                                                   uint16_t indexTx, uint16_t indexRx) const
 {
   NS_LOG_FUNCTION (this << indexTx << indexRx);
   std::string rayTracingPrefixFile  = m_qdFolder + "QdFiles/Tx";
-  float2DVector_t rotmAod[8];     /* Rotation Matrix used to manage Angles of Departure depending on antenna orientation. */
-  float2DVector_t rotmAoa[8];     /* Rotation Matrix used to manage Angles of Arrival depending on antenna orientation. */
-  uint16_t traceIndex = 0;        /* Used for mobility. */
-
-  Ptr<NetDevice> txDevice = txMobility->GetObject<Node> ()->GetDevice (0);
-  Ptr<NetDevice> rxDevice = rxMobility->GetObject<Node> ()->GetDevice (0);
-  Ptr<WifiNetDevice> wifiTxDevice = DynamicCast<WifiNetDevice> (txDevice);
-  Ptr<WifiNetDevice> wifiRxDevice = DynamicCast<WifiNetDevice> (rxDevice);
-  Ptr<SpectrumDmgWifiPhy> txSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiTxDevice->GetPhy ());
-  Ptr<SpectrumDmgWifiPhy> rxSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiRxDevice->GetPhy ());
-  Ptr<CodebookParametric> txCodebook = DynamicCast<CodebookParametric> (txSpectrum->GetCodebook ());
-  Ptr<CodebookParametric> rxCodebook = DynamicCast<CodebookParametric> (rxSpectrum->GetCodebook ());
-
-  uint8_t numTxAntennas = txCodebook->GetTotalNumberOfAntennas ();
-  uint8_t numRxAntennas = rxCodebook->GetTotalNumberOfAntennas ();
+  const RotationMatrix *rotmAod[8];   /* Rotation Matrix used to manage Angles of Departure depending on antenna orientation. */
+  const RotationMatrix *rotmAoa[8];   /* Rotation Matrix used to manage Angles of Arrival depending on antenna orientation. */
+  uint32_t traceIndex = 0;        /* Used for mobility. */
+
+  uint8_t numTxAntennas = tx.codebook->GetTotalNumberOfAntennas ();
+  uint8_t numRxAntennas = rx.codebook->GetTotalNumberOfAntennas ();
 
   for (AntennaID i = 1 ; i <= numTxAntennas; i++)
     {
-      EulerTransform (txSpectrum->GetCodebook ()->GetOrientation (i), rotmAod[i-1]);
+      rotmAod[i-1] = &GetRotationMatrix (tx.codebook->GetOrientation (i));
     }
   for (AntennaID i = 1 ; i <= numRxAntennas; i++)
     {
-      EulerTransform (rxSpectrum->GetCodebook ()->GetOrientation (i), rotmAoa[i-1]);
+      rotmAoa[i-1] = &GetRotationMatrix (rx.codebook->GetOrientation (i));
     }
 
   std::string qdParameterFile;
@@ -164,137 +217,116 @@ QdPropagationEngine::InitializeQDModelParameters (Ptr<const MobilityModel> txMob
   /* Open the QD-model files (generated by Matlab) between transmitter and receiver */
   qdParameterFile = std::string (rayTracingPrefixFile) + std::string (indexTxStr) + std::string ("Rx")
       + std::string (indexRxStr) + std::string (".txt");
-  NS_LOG_INFO ("Open Q-D Channel Model File: " << qdParameterFile);
 
-  std::ifstream qdFile;
-  qdFile.open (qdParameterFile.c_str (), std::ifstream::in);
-  if (!qdFile.good ())
+  /* Prefer the binary Q-D file if it has been generated from the current text file, otherwise parse the text file */
+  Ptr<QdChannelStore> store = Create<QdChannelStore> ();
+  std::string binaryFile = QdChannelStore::GetBinaryFileName (qdParameterFile);
+  if (store->Open (binaryFile, qdParameterFile, numTxAntennas, numRxAntennas))
     {
-      NS_FATAL_ERROR ("Error Opening Q-D Channel Model File: " << qdParameterFile);
+      NS_LOG_INFO ("Map binary Q-D Channel Model File: " << binaryFile);
     }
-
-  std::string line;
-  std::string token;
-  uint16_t numPath = 0;
-  QdChanneldentifier chId;     /* Q-D Channel Profile Identifier */
-
-  /* Parse each line of the Q-D file */
-  while (true)
+  else
+    {
+      NS_LOG_INFO ("Open Q-D Channel Model File: " << qdParameterFile);
+      if (!store->LoadTextFile (qdParameterFile, numTxAntennas, numRxAntennas))
+        {
+          NS_FATAL_ERROR ("Error Opening Q-D Channel Model File: " << qdParameterFile);
+        }
+    }
+  QdChannelPair &channelPair = m_channelPairs[std::make_pair (indexTx, indexRx)];
+  channelPair.store = store;
+  channelPair.numTxAntennas = numTxAntennas;
+  channelPair.numRxAntennas = numRxAntennas;
+  channelPair.numTraces = store->GetNumTraces ();
+  channelPair.channels.resize (channelPair.numTraces * numTxAntennas * numRxAntennas);
+
+  std::vector<QdChannelParameters>::iterator channelIt = channelPair.channels.begin ();
+  for (traceIndex = 0; traceIndex < channelPair.numTraces; traceIndex++)
     {
       for (AntennaID i = 1 ; i <= numTxAntennas; i++)
         {
-          for (AntennaID j = 1 ; j <= numRxAntennas; j++)
+          for (AntennaID j = 1 ; j <= numRxAntennas; j++, channelIt++)
             {
-              chId = std::make_tuple (indexTx, indexRx, traceIndex, i, j);
-              for (uint16_t parameterNumber = 0; parameterNumber < 8; parameterNumber++)
+              QdChannelRecord record = store->GetRecord (traceIndex, i, j);
+              QdChannelParameters &channel = *channelIt;
+              uint16_t numPath = record.numPaths;
+              channel.numPaths = numPath;
+              channel.delay = record.delay;
+              channel.pathLoss = record.pathLoss;
+              channel.phase = record.phase;
+              if (numPath == 0)
                 {
-                  std::getline (qdFile, line);
-                  if (qdFile.eof ())
-                    {
-                      goto closeFile;
-                    }
-                  /* First parameter is the number of multipaths */
-                  if (parameterNumber == 0)
-                    {
-                      numPath = std::stoul (line);
-                      nbMultipathTxRx[chId] = numPath;
-                    }
-                  if ((numPath > 0) && (parameterNumber > 0))
-                    {
-                      floatVector_t values;
-                      std::istringstream stream (line);
-                      while (std::getline (stream, token, ',')) /* Parse each comma separated string in a line */
-                        {
-                          float tokenValue = 0.00;
-                          std::stringstream stream (token) ;
-                          stream >> tokenValue;
-                          values.push_back (tokenValue);
-                        }
-                      switch (parameterNumber)
-                        {
-                          case 1:
-                            /* Second parameter is the delay */
-                            delayTxRx[chId] = values;
-                            break;
-
-                          case 2:
-                            /* Third parameter is the path Loss */
-                            pathLossTxRx[chId] = values;
-                            break;
-
-                          case 3:
-                            /* Fourth parameter is the phase */
-                            phaseTxRx[chId] = values;
-                            break;
-
-                          case 4:
-                            /* Fifth parameter is the AoD Elevation */
-                            aodElevationTxRx[chId] = values;
-                            break;
-
-                          case 5:
-                            /* Sixth parameter is the AoD Azimuth */
-                            aodAzimuthTxRx[chId] = values;
-
-                            /* AoD Antenna orientation transformation */
-                            float elevationMultipath, azimuthMultipath;
-                            AnglesTransformed angles;
-                            for (uint16_t k = 0; k < numPath; k++)
-                              {
-                                elevationMultipath = DegreesToRadians (aodElevationTxRx[chId].at (k));
-                                azimuthMultipath = DegreesToRadians (aodAzimuthTxRx[chId].at (k));
-                                angles = GetTransformedAngles (elevationMultipath, azimuthMultipath, false, rotmAod[i-1]);
-                                aodElevationTxRx[chId].at (k) = angles.elevation;
-                                aodAzimuthTxRx[chId].at (k) = angles.azimuth;
-                                if (!txCodebook->ArrayPatternsPrecalculated ())
-                                  {
-                                    txCodebook->CalculateArrayPatterns (i, angles.azimuth, angles.elevation);
-                                  }
-                              }
-
-                            break;
-
-                          case 6:
-                            /* Seventh parameter is the AoA Elevation */
-                            aoaElevationTxRx[chId] = values;
-                            break;
-
-                          case 7:
-                            /* Eighth parameter is the AoA Azimuth */
-                            aoaAzimuthTxRx[chId] = values;
-
-                            /* AoA Antenna orientation transformation */
-                            for (uint16_t k = 0; k < numPath; k++)
-                              {
-                                elevationMultipath = DegreesToRadians (aoaElevationTxRx[chId].at (k));
-                                azimuthMultipath = DegreesToRadians (aoaAzimuthTxRx[chId].at (k));
-                                angles = GetTransformedAngles (elevationMultipath, azimuthMultipath, false, rotmAoa[j-1]);
-                                aoaElevationTxRx[chId].at (k) = angles.elevation;
-                                aoaAzimuthTxRx[chId].at (k) = angles.azimuth;
-                                if (!rxCodebook->ArrayPatternsPrecalculated ())
-                                  {
-                                    rxCodebook->CalculateArrayPatterns (j, angles.azimuth, angles.elevation);
-                                  }
-                              }
-
-                            break;
-                          }
-                    }
-                  else if ((numPath == 0) && (parameterNumber == 0))
-                    {
-                      /* Handle a special case when there is no channel between devices/antennas */
-                      nbMultipathTxRx[chId] = 0;
-                      break;
-                    }
+                  /* Handle a special case when there is no channel between devices/antennas */
+                  continue;
                 }
+              channel.angles.resize (4 * numPath);
+              uint16_t *aodAzimuth = &channel.angles[0];
+              uint16_t *aodElevation = aodAzimuth + numPath;
+              uint16_t *aoaAzimuth = aodElevation + numPath;
+              uint16_t *aoaElevation = aoaAzimuth + numPath;
+
+              /* AoD Antenna orientation transformation */
+              TransformAngles (record.aodElevation, record.aodAzimuth, numPath, *rotmAod[i-1],
+                               aodElevation, aodAzimuth);
+
+              /* AoA Antenna orientation transformation */
+              TransformAngles (record.aoaElevation, record.aoaAzimuth, numPath, *rotmAoa[j-1],
+                               aoaElevation, aoaAzimuth);
             }
         }
-      traceIndex++;
     }
 
-closeFile:
-  m_numTraces = traceIndex;
-  qdFile.close ();
+  /* Consecutive traces with identical parameters share the same generation,
+   * so the channel gains cached for the previous trace remain valid. */
+  uint32_t numChannels = numTxAntennas * numRxAntennas;
+  for (uint32_t index = 0; index < channelPair.channels.size (); index++)
+    {
+      QdChannelParameters &channel = channelPair.channels[index];
+      if ((index >= numChannels) && IdenticalChannels (channel, channelPair.channels[index - numChannels]))
+        {
+          channel.generation = channelPair.channels[index - numChannels].generation;
+        }
+      else
+        {
+          channel.generation = m_nextGeneration++;
+          if (m_interval.IsStrictlyPositive ())
+            {
+              /* Draw the Doppler shifts of the new realization once, so that a channel gain
+               * recomputed after being evicted from the cache gets the same Doppler effect */
+              m_dopplerEffects.resize (m_nextGeneration);
+              QdDopplerEffect &doppler = m_dopplerEffects[channel.generation];
+              doppler.shift.resize (channel.numPaths);
+              for (uint16_t i = 0; i < channel.numPaths; i++)
+                {
+                  doppler.shift[i] = m_uniformRv->GetValue (0, 1);
+                }
+              uint32_t traceIndex = std::max (index / numChannels, m_startIndex);
+              doppler.time = m_interval.GetSeconds () * (traceIndex - m_startIndex);
+            }
+        }
+    }
+
+  m_numTraces = channelPair.numTraces;
+}
+
+QdChannelParameters *
+QdPropagationEngine::GetChannelParameters (uint32_t indexTx, uint32_t indexRx, uint32_t traceIndex,
+                                           AntennaID txAntenna, AntennaID rxAntenna) const
+{
+  QdChannelPairMap_I it = m_channelPairs.find (std::make_pair (indexTx, indexRx));
+  if (it == m_channelPairs.end ())
+    {
+      return 0;
+    }
+  QdChannelPair &channelPair = it->second;
+  if ((traceIndex >= channelPair.numTraces)
+      || (txAntenna < 1) || (txAntenna > channelPair.numTxAntennas)
+      || (rxAntenna < 1) || (rxAntenna > channelPair.numRxAntennas))
+    {
+      return 0;
+    }
+  uint32_t channelIndex = (traceIndex * channelPair.numTxAntennas + (txAntenna - 1)) * channelPair.numRxAntennas + (rxAntenna - 1);
+  return &channelPair.channels[channelIndex];
 }
 
 void
@@ -396,126 +428,242 @@ Time
 QdPropagationEngine::GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
 {
   NS_LOG_FUNCTION (this << a << b);
-  uint32_t indexTx, indexRx;
+  Ptr<const QdDeviceHandle> tx = GetDeviceHandle (a);
+  Ptr<const QdDeviceHandle> rx = GetDeviceHandle (b);
+  uint32_t indexTx = GetQdIndex (*tx);
+  uint32_t indexRx = GetQdIndex (*rx);
 
-  Ptr<NetDevice> txDevice = a->GetObject<Node> ()->GetDevice (0);
-  Ptr<WifiNetDevice> wifiTxDevice = DynamicCast<WifiNetDevice> (txDevice);
-  Ptr<SpectrumDmgWifiPhy> txSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiTxDevice->GetPhy ());
-  Ptr<CodebookParametric> txCodebook = DynamicCast<CodebookParametric> (txSpectrum->GetCodebook ());
+  /* Mobility Management */
+  HandleMobility ();
 
-  Ptr<NetDevice> rxDevice = b->GetObject<Node> ()->GetDevice (0);
-  Ptr<WifiNetDevice> wifiRxDevice = DynamicCast<WifiNetDevice> (rxDevice);
-  Ptr<SpectrumDmgWifiPhy> rxSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiRxDevice->GetPhy ());
-  Ptr<CodebookParametric> rxCodebook = DynamicCast<CodebookParametric> (rxSpectrum->GetCodebook ());
+  if (m_channelPairs.find (std::make_pair (indexTx, indexRx)) == m_channelPairs.end ())
+    {
+      /* Load Q-D files in order to fill all the needed parameters to compute channel gain */
+      InitializeQDModelParameters (*tx, *rx, indexTx, indexRx);
+    }
 
-  if (m_useCustomIDs)
+  /* The first multipath component has the smallest propagation delay */
+  const QdChannelParameters *channel = GetChannelParameters (indexTx, indexRx, m_currentIndex,
+                                                             tx->codebook->GetActiveAntennaID (),
+                                                             rx->codebook->GetActiveAntennaID ());
+  if ((channel != 0) && (channel->numPaths > 0))
     {
-      indexTx = GetQdID (txDevice->GetNode ()->GetId ());
-      indexRx = GetQdID (rxDevice->GetNode ()->GetId ());
+      return Seconds (channel->delay[0]);
     }
   else
     {
-      indexTx = txDevice->GetNode ()->GetId ();
-      indexRx = rxDevice->GetNode ()->GetId ();
+      return Seconds (0);
     }
+}
 
-  /* Mobility Management */
-  HandleMobility ();
+/**
+ * The number of subbands whose delay phasors are computed directly. The phasor of every other
+ * subband is obtained by rotating the phasor QD_GAIN_LANES subbands below it, so consecutive
+ * subbands do not depend on each other and the rotation is vectorized by the compiler.
+ */
+#define QD_GAIN_LANES           8
+/**
+ * The number of subbands after which the phasors are computed directly again
+ * to bound the accumulation of rounding errors.
+ */
+#define QD_GAIN_RESYNC_BANDS    512
+
+/**
+ * Compute the contribution of a multipath component to each subband of a uniform frequency grid.
+ * \param amplitudeRe The real part of the complex amplitude of the multipath component.
+ * \param amplitudeIm The imaginary part of the complex amplitude of the multipath component.
+ * \param delay The delay of the multipath component in seconds.
+ * \param f0 The center frequency of the first subband in Hz.
+ * \param df The spacing between two consecutive subbands in Hz.
+ * \param numBands The number of subbands.
+ * \param phasors The contribution of each subband (interleaved real and imaginary parts).
+ */
+static void
+ComputeUniformPathPhasors (double amplitudeRe, double amplitudeIm, double delay,
+                           double f0, double df, size_t numBands, double *phasors)
+{
+  double stepAngle = -2 * M_PI * QD_GAIN_LANES * df * delay;
+  double stepRe = cos (stepAngle);
+  double stepIm = sin (stepAngle);
+  for (size_t first = 0; first < numBands; first += QD_GAIN_RESYNC_BANDS)
+    {
+      size_t last = std::min (first + QD_GAIN_RESYNC_BANDS, numBands);
+      size_t lanes = std::min (first + QD_GAIN_LANES, last);
+      for (size_t band = first; band < lanes; band++)
+        {
+          double angle = -2 * M_PI * (f0 + band * df) * delay;
+          double c = cos (angle);
+          double s = sin (angle);
+          phasors[2 * band] = amplitudeRe * c - amplitudeIm * s;
+          phasors[2 * band + 1] = amplitudeRe * s + amplitudeIm * c;
+        }
+      for (size_t band = lanes; band < last; band++)
+        {
+          double re = phasors[2 * (band - QD_GAIN_LANES)];
+          double im = phasors[2 * (band - QD_GAIN_LANES) + 1];
+          phasors[2 * band] = re * stepRe - im * stepIm;
+          phasors[2 * band + 1] = re * stepIm + im * stepRe;
+        }
+    }
+}
 
-  CommunicatingPair pair = std::make_pair (indexTx, indexRx);
-  TraceFiles_I trIt = find (m_traceFiles.begin (), m_traceFiles.end (), pair);
-  if (trIt == m_traceFiles.end ())
+/**
+ * Compute the complex gain of each subband from the multipath components of a channel.
+ * \param amplitudes The complex amplitude of each multipath component.
+ * \param delays The delay of each multipath component in seconds.
+ * \param frequencies The center frequency of each subband in Hz.
+ * \param gains The complex gain of each subband (interleaved real and imaginary parts).
+ */
+static void
+ComputeSubbandGains (const std::vector<std::complex<double> > &amplitudes, const float *delays,
+                     const std::vector<double> &frequencies, std::vector<double> &gains)
+{
+  /* Check whether the subbands are evenly spaced */
+  size_t numBands = frequencies.size ();
+  double f0 = frequencies.front ();
+  double df = (numBands > 1) ? (frequencies.back () - f0) / (numBands - 1) : 0;
+  bool uniformGrid = true;
+  for (size_t band = 0; (band < numBands) && uniformGrid; band++)
     {
-      /* Load Q-D files in order to fill all the needed parameters to compute channel gain */
-      InitializeQDModelParameters (a, b, indexTx, indexRx);
-      m_traceFiles.push_back (pair);
+      uniformGrid = (std::abs (frequencies[band] - (f0 + band * df)) <= 1.0);
     }
 
-  /* Create Q-D channel identifier */
-  QdChanneldentifier chId = std::make_tuple (indexTx, indexRx, m_currentIndex,
-                                             txCodebook->GetActiveAntennaID (), rxCodebook->GetActiveAntennaID ());
+  gains.assign (2 * numBands, 0.0);
+  std::vector<double> phasors (2 * numBands);
+  for (size_t pathIndex = 0; pathIndex < amplitudes.size (); pathIndex++)
+    {
+      /* Rotate the complex amplitude by the delay phase of each subband */
+      const std::complex<double> &amplitude = amplitudes[pathIndex];
+      double delay = delays[pathIndex];
+      if (uniformGrid)
+        {
+          ComputeUniformPathPhasors (amplitude.real (), amplitude.imag (), delay,
+                                     f0, df, numBands, phasors.data ());
+        }
+      else
+        {
+          for (size_t band = 0; band < numBands; band++)
+            {
+              double angle = -2 * M_PI * frequencies[band] * delay;
+              double c = cos (angle);
+              double s = sin (angle);
+              phasors[2 * band] = amplitude.real () * c - amplitude.imag () * s;
+              phasors[2 * band + 1] = amplitude.real () * s + amplitude.imag () * c;
+            }
+        }
 
-  /* The first multipath component has the smallest propagation delay */
-  ChannelCoefficientMap_I it = delayTxRx.find (chId);
-  if (it != delayTxRx.end ())
+      /* Add multipath effect to the subband gains */
+      for (size_t i = 0; i < 2 * numBands; i++)
+        {
+          gains[i] += phasors[i];
+        }
+    }
+}
+
+/**
+ * Get the center frequency of each subband of a power spectral density.
+ * \param psd The power spectral density.
+ * \param frequencies The center frequency of each subband in Hz.
+ */
+static void
+GetSubbandFrequencies (Ptr<const SpectrumValue> psd, std::vector<double> &frequencies)
+{
+  frequencies.clear ();
+  frequencies.reserve (psd->GetSpectrumModel ()->GetNumBands ());
+  for (Bands::const_iterator fit = psd->ConstBandsBegin (); fit != psd->ConstBandsEnd (); fit++)
     {
-      return Seconds (delayTxRx[chId].at (0));
+      frequencies.push_back (fit->fc);
     }
-  else
+}
+
+/**
+ * Multiply the power of each subband by the squared magnitude of its complex gain.
+ * \param psd The power spectral density.
+ * \param gains The complex gain of each subband (interleaved real and imaginary parts)
+ * or an empty vector if there is no channel.
+ */
+static void
+ApplySubbandGains (Ptr<SpectrumValue> psd, const std::vector<double> &gains)
+{
+  size_t band = 0;
+  for (Values::iterator vit = psd->ValuesBegin (); vit != psd->ValuesEnd (); vit++, band++)
     {
-      return Seconds (0);
+      if (gains.empty ())
+        {
+          /* Handle a special case when there is no channel between devices/antennas */
+          *vit = (*vit) * 0.0;
+        }
+      else if ((*vit) != 0.00)
+        {
+          *vit = (*vit) * (gains[2 * band] * gains[2 * band] + gains[2 * band + 1] * gains[2 * band + 1]);
+        }
+    }
+}
+
+void
+QdPrefetchJob::Run (void)
+{
+  for (std::vector<QdPrefetchTask>::iterator it = tasks.begin (); it != tasks.end (); it++)
+    {
+      ComputeSubbandGains (it->amplitudes, it->delays.data (), it->frequencies, it->gains);
+    }
+}
+
+void
+QdPropagationEngine::ComputePathAmplitudes (const QdChannelParameters *channel,
+                                            Ptr<CodebookParametric> txCodebook, Ptr<CodebookParametric> rxCodebook,
+                                            Ptr<PatternConfig> txPattern, Ptr<PatternConfig> rxPattern,
+                                            std::vector<std::complex<double> > &amplitudes) const
+{
+  /* Compute the part of each multipath component that does not depend on the subband, i.e.,
+   * the path gain, the phase, the Doppler effect and the gain of the Tx and Rx antenna patterns */
+  // Normalize at the receiver to take into acccount noise amplification (Check our WiKi page
+  // for more explanation regarding link budget calculations).
+  float normalizationFactor = DynamicCast<ParametricPatternConfig> (rxPattern)->GetNormalizationFactor ();
+  std::complex<double> doppler (1, 0);
+  Complex txSum, rxSum;
+  amplitudes.resize (channel->numPaths);
+  for (uint16_t pathIndex = 0; pathIndex < channel->numPaths; pathIndex++)
+    {
+      if (m_interval.IsStrictlyPositive ())
+        {
+          /* TODO We are not yet using Doppler */
+          double f_d = 0.8;
+          const QdDopplerEffect &effect = m_dopplerEffects[channel->generation];
+          doppler = std::polar (1.0, 2 * M_PI * effect.time * f_d * effect.shift[pathIndex]);
+        }
+      txSum = txCodebook->GetAntennaArrayPattern (txPattern,
+                                                  channel->GetAodAzimuth ()[pathIndex],
+                                                  channel->GetAodElevation ()[pathIndex]);
+      rxSum = rxCodebook->GetAntennaArrayPattern (rxPattern,
+                                                  channel->GetAoaAzimuth ()[pathIndex],
+                                                  channel->GetAoaElevation ()[pathIndex]);
+      rxSum /= normalizationFactor;
+      amplitudes[pathIndex] = std::sqrt (std::pow (10.0, channel->pathLoss[pathIndex] / 10.0))
+                              * std::polar (1.0, double (channel->phase[pathIndex])) * doppler
+                              * std::complex<double> (txSum) * std::complex<double> (rxSum);
     }
 }
 
 Ptr<SpectrumValue>
-QdPropagationEngine::GetChannelGain (Ptr<SpectrumValue> rxPsd,
-                                     uint16_t pathNum, QdChanneldentifier chId,
+QdPropagationEngine::GetChannelGain (Ptr<SpectrumValue> rxPsd, const QdChannelParameters *channel,
                                      Ptr<CodebookParametric> txCodebook, Ptr<CodebookParametric> rxCodebook,
                                      Ptr<PatternConfig> txPattern, Ptr<PatternConfig> rxPattern) const
 {
+  uint16_t pathNum = (channel == 0) ? 0 : channel->numPaths;
   NS_LOG_FUNCTION (this << pathNum);
-  double t = Simulator::Now ().GetSeconds ();
   Ptr<SpectrumValue> tempPsd = Copy<SpectrumValue> (rxPsd);
-  Bands::const_iterator fit = tempPsd->ConstBandsBegin ();
-
-  float temp_delay, f_d, temp_Doppler, pathPowerLinear, phase;
-  Complex delay, doppler,complexPhase, smallScaleFading, txSum, rxSum;
-  uint16_t indexTxAzimuth, indexTxElevation, indexRxAzimuth, indexRxElevation;
-
-  /* Iterate through tempPsd (vectors containing the power corresponding to a subband) to compute the gain */
-  for (Values::iterator vit = tempPsd->ValuesBegin (); vit != tempPsd->ValuesEnd (); vit++, fit++)
+  std::vector<double> gains;
+  if (pathNum > 0)
     {
-      if ((*vit) != 0.00)
-        {
-          Complex subsbandGain (0.0, 0.0);
-          if (pathNum > 0)
-            {
-              for (uint pathIndex = 0; pathIndex < pathNum; pathIndex++)
-                {
-                  temp_delay = -2 * M_PI * fit->fc * delayTxRx[chId].at (pathIndex);
-                  delay = Complex (cos (temp_delay), sin (temp_delay));
-
-                  if (m_interval.IsStrictlyPositive ())
-                    {
-                      /* TODO We are not yet using Doppler */
-                      f_d = 0.8;
-                      temp_Doppler = 2*M_PI*t*f_d*dopplerShiftTxRx[chId].at (pathIndex);
-                      doppler = Complex (cos (temp_Doppler), sin (temp_Doppler));
-                    }
-                  else
-                    {
-                      doppler = Complex (1, 0);
-                    }
-
-                  pathPowerLinear = std::pow (10.0, (pathLossTxRx[chId].at (pathIndex))/10.0);
-                  phase = phaseTxRx[chId].at (pathIndex);
-                  complexPhase = Complex (cos (phase), sin (phase));
-                  smallScaleFading = float (sqrt (pathPowerLinear)) * doppler * delay * complexPhase;
-
-                  /* Compute the gain for each subband */
-                  indexTxAzimuth = aodAzimuthTxRx[chId].at (pathIndex);
-                  indexTxElevation = aodElevationTxRx[chId].at (pathIndex);
-                  txSum = txCodebook->GetAntennaArrayPattern (txPattern, indexTxAzimuth, indexTxElevation);
-
-                  indexRxAzimuth = aoaAzimuthTxRx[chId].at (pathIndex);
-                  indexRxElevation = aoaElevationTxRx[chId].at (pathIndex);
-                  rxSum = rxCodebook->GetAntennaArrayPattern (rxPattern, indexRxAzimuth, indexRxElevation);
-                  // Normalize at the receiver to take into acccount noise amplification (Check our WiKi page
-                  // for more explanation regarding link budget calculations).
-                  rxSum /= DynamicCast<ParametricPatternConfig> (rxPattern)->GetNormalizationFactor ();
-
-                  /* Add multipath effect to the subband gain */
-                  subsbandGain = subsbandGain + rxSum * txSum * smallScaleFading;
-                }
-            }
-          else
-            {
-              subsbandGain = -std::numeric_limits<Complex>::infinity ();
-            }
-          /* All Multipath Done - Compute the power for the subband */
-          *vit = (*vit) * (std::norm (subsbandGain));
-        }
+      std::vector<std::complex<double> > amplitudes;
+      std::vector<double> frequencies;
+      ComputePathAmplitudes (channel, txCodebook, rxCodebook, txPattern, rxPattern, amplitudes);
+      GetSubbandFrequencies (tempPsd, frequencies);
+      ComputeSubbandGains (amplitudes, channel->delay, frequencies, gains);
     }
+  /* All Multipath Done - Compute the power for each subband */
+  ApplySubbandGains (tempPsd, gains);
   return tempPsd;
 }
 
@@ -529,128 +677,322 @@ QdPropagationEngine::HandleMobility (void) const
       /* We keep using the channel corresponding to the last entry in the Q-D file */
       if ((traceIndex < m_numTraces) && (traceIndex != m_currentIndex))
         {
+          /* Cached channel gains are refreshed lazily when their Q-D channel has changed */
+          uint32_t previousIndex = m_currentIndex;
           m_currentIndex = traceIndex;
-          m_channelGainMatrix.clear ();
+          if (m_prefetch)
+            {
+              FinishPrefetch ();
+              StartPrefetch (previousIndex);
+            }
         }
     }
 }
 
-Ptr<SpectrumValue>
-QdPropagationEngine::CalcRxPower (Ptr<SpectrumSignalParameters> params,
-				  Ptr<const MobilityModel> a,
-				  Ptr<const MobilityModel> b) const
+void
+QdPropagationEngine::StartPrefetch (uint32_t activeIndex) const
 {
-  NS_LOG_FUNCTION (this);
-
-  uint32_t indexTx, indexRx;
-
-  Ptr<DmgWifiSpectrumSignalParameters> rxParams = DynamicCast<DmgWifiSpectrumSignalParameters> (params);
-
-  Ptr<NetDevice> txDevice = a->GetObject<Node> ()->GetDevice (0);
-  Ptr<NetDevice> rxDevice = b->GetObject<Node> ()->GetDevice (0);
-
-  Ptr<WifiNetDevice> wifiTxDevice = DynamicCast<WifiNetDevice> (txDevice);
-  Ptr<SpectrumDmgWifiPhy> txSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiTxDevice->GetPhy ());
-  Ptr<CodebookParametric> txCodebook = DynamicCast<CodebookParametric> (txSpectrum->GetCodebook ());
+  NS_LOG_FUNCTION (this << activeIndex);
+  uint32_t nextIndex = m_currentIndex + 1;
+  if (nextIndex >= m_numTraces)
+    {
+      return;
+    }
 
-  Ptr<WifiNetDevice> wifiRxDevice = DynamicCast<WifiNetDevice> (rxDevice);
-  Ptr<SpectrumDmgWifiPhy> rxSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiRxDevice->GetPhy ());
-  Ptr<CodebookParametric> rxCodebook = DynamicCast<CodebookParametric> (rxSpectrum->GetCodebook ());
+  /* The links used during the previous trace are expected to remain active, compute the gains
+   * of the ones whose Q-D channel changes in the next trace. Their inputs are gathered here since
+   * the codebooks must not be accessed from the worker thread. */
+  Ptr<QdPrefetchJob> job = Create<QdPrefetchJob> ();
+  job->traceIndex = nextIndex;
+  for (LinkConfigurationList::const_iterator it = m_channelGainLru.begin (); it != m_channelGainLru.end (); it++)
+    {
+      const ChannelGainEntry &entry = m_channelGainMatrix.find (*it)->second;
+      if (entry.lastUsed != activeIndex)
+        {
+          /* The remaining links have been used before the previous trace */
+          break;
+        }
+      QdChannelParameters *channel = GetChannelParameters (entry.indexTx, entry.indexRx, nextIndex,
+                                                           it->txAntenna, it->rxAntenna);
+      if ((channel == 0) || (channel->numPaths == 0) || (channel->generation == entry.generation))
+        {
+          continue;
+        }
+      QdPrefetchTask task;
+      task.key = *it;
+      task.generation = channel->generation;
+      ComputePathAmplitudes (channel, entry.txCodebook, entry.rxCodebook, entry.txPattern, entry.rxPattern,
+                             task.amplitudes);
+      task.delays.assign (channel->delay, channel->delay + channel->numPaths);
+      GetSubbandFrequencies (entry.rxPsd, task.frequencies);
+      job->tasks.push_back (task);
+    }
+  if (job->tasks.empty ())
+    {
+      return;
+    }
 
-  AntennaConfigTx antennaConfigTx = std::make_pair (rxParams->antennaId,
-                                                    rxParams->txPatternConfig);
-  AntennaConfigRx antennaConfigRx = std::make_pair (rxCodebook->GetActiveAntennaID (),
-                                                    rxCodebook->GetRxPatternConfig ());
+  NS_LOG_DEBUG ("Prefetch " << job->tasks.size () << " channel gains for trace " << nextIndex);
+  m_prefetchJob = job;
+#ifdef HAVE_PTHREAD_H
+  m_prefetchThread = Create<SystemThread> (MakeCallback (&QdPrefetchJob::Run, PeekPointer (job)));
+  m_prefetchThread->Start ();
+#else
+  job->Run ();
+#endif
+}
 
-  LinkConfiguration key = std::make_tuple (txDevice, rxDevice, antennaConfigTx, antennaConfigRx);
+void
+QdPropagationEngine::FinishPrefetch (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_prefetchJob == 0)
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  m_prefetchThread->Join ();
+  m_prefetchThread = 0;
+#endif
+  Ptr<QdPrefetchJob> job = m_prefetchJob;
+  m_prefetchJob = 0;
+  if (job->traceIndex != m_currentIndex)
+    {
+      /* The trace the gains were computed for has been skipped */
+      return;
+    }
 
-  if (m_useCustomIDs)
+  /* Keep the prefetched gains until the links are used, so they are applied to the PSD
+   * of the signal received at that time like the channel gains computed on demand */
+  for (std::vector<QdPrefetchTask>::iterator task = job->tasks.begin (); task != job->tasks.end (); task++)
     {
-      indexTx = GetQdID (txDevice->GetNode ()->GetId ());
-      indexRx = GetQdID (rxDevice->GetNode ()->GetId ());
+      ChannelGainMatrix_I it = m_channelGainMatrix.find (task->key);
+      if ((it == m_channelGainMatrix.end ()) || (it->second.generation == task->generation))
+        {
+          continue;
+        }
+      it->second.prefetchedGains.swap (task->gains);
+      it->second.prefetchedGeneration = task->generation;
     }
-  else
+}
+
+bool
+LinkConfiguration::operator == (const LinkConfiguration &other) const
+{
+  return (txNode == other.txNode) && (rxNode == other.rxNode)
+    && (txAntenna == other.txAntenna) && (rxAntenna == other.rxAntenna)
+    && (txPattern == other.txPattern) && (rxPattern == other.rxPattern)
+    && (spectrumModel == other.spectrumModel);
+}
+
+size_t
+LinkConfigurationHash::operator () (const LinkConfiguration &key) const
+{
+  /* FNV-1a over the fields of the key */
+  uint64_t fields[5] = {key.txNode, key.rxNode, (uint64_t (key.txAntenna) << 8) | key.rxAntenna,
+                        (uint64_t (key.txPattern) << 32) | key.rxPattern, key.spectrumModel};
+  uint64_t hash = 14695981039346656037ULL;
+  for (uint32_t i = 0; i < 5; i++)
     {
-      indexTx = txDevice->GetNode ()->GetId ();
-      indexRx = rxDevice->GetNode ()->GetId ();
+      hash = (hash ^ fields[i]) * 1099511628211ULL;
     }
+  return hash;
+}
 
-  /* Mobility Management */
-  HandleMobility ();
+LinkConfiguration
+QdPropagationEngine::GetLinkConfiguration (Ptr<NetDevice> txDevice, Ptr<NetDevice> rxDevice,
+                                           const AntennaConfigTx &txConfig, const AntennaConfigRx &rxConfig,
+                                           Ptr<const SpectrumValue> rxPsd) const
+{
+  LinkConfiguration key;
+  key.txNode = txDevice->GetNode ()->GetId ();
+  key.rxNode = rxDevice->GetNode ()->GetId ();
+  key.txAntenna = txConfig.first;
+  key.rxAntenna = rxConfig.first;
+  key.txPattern = (txConfig.second == 0) ? 0 : txConfig.second->GetPatternId ();
+  key.rxPattern = (rxConfig.second == 0) ? 0 : rxConfig.second->GetPatternId ();
+  key.spectrumModel = rxPsd->GetSpectrumModelUid ();
+  return key;
+}
 
+Ptr<SpectrumValue>
+QdPropagationEngine::GetCachedChannelGain (const LinkConfiguration &key, uint32_t indexTx, uint32_t indexRx,
+                                           Ptr<SpectrumValue> rxPsd,
+                                           Ptr<CodebookParametric> txCodebook, Ptr<CodebookParametric> rxCodebook,
+                                           Ptr<PatternConfig> txPattern, Ptr<PatternConfig> rxPattern) const
+{
+  QdChannelParameters *channel = GetChannelParameters (indexTx, indexRx, m_currentIndex,
+                                                       key.txAntenna, key.rxAntenna);
+  uint32_t generation = (channel == 0) ? 0 : channel->generation;
   ChannelGainMatrix_I it = m_channelGainMatrix.find (key);
-  Ptr<SpectrumValue> chPsd;
 
   /* Check if the channel has already been computed between transmitter and receiver for certain antenna configurations */
-  if (it == m_channelGainMatrix.end ())
+  if (it != m_channelGainMatrix.end ())
     {
-      QdChanneldentifier chId = std::make_tuple (indexTx, indexRx, m_currentIndex,
-                                                 rxParams->antennaId, rxCodebook->GetActiveAntennaID ());
-
-      uint16_t pathNum = nbMultipathTxRx[chId];
-
-      /* Doppler effect */
-      if (m_interval.IsStrictlyPositive ())
+      m_channelGainLru.splice (m_channelGainLru.begin (), m_channelGainLru, it->second.lru);
+      it->second.lastUsed = m_currentIndex;
+      if (it->second.generation == generation)
         {
-          floatVector_t dopplerShiftVec;
-          for (uint16_t i = 0; i < pathNum; i++)
-            {
-              dopplerShiftVec.push_back (m_uniformRv->GetValue (0, 1));
-            }
-          dopplerShiftTxRx[chId] = dopplerShiftVec;
+          m_channelGainCacheHits++;
+          return it->second.gain;
         }
+    }
+  m_channelGainCacheMisses++;
 
-      /*
-       * Insert the channel into the Channel matrix to avoid
-       * recomputing the channel every time if there is no Mobility.
-       */
-      chPsd = GetChannelGain (rxParams->psd, pathNum, chId,
-                              txCodebook, rxCodebook,
-                              rxParams->txPatternConfig, rxCodebook->GetRxPatternConfig ());
-      m_channelGainMatrix[key] = chPsd;
+  /*
+   * Insert the channel into the Channel matrix to avoid
+   * recomputing the channel every time if there is no Mobility.
+   */
+  Ptr<SpectrumValue> chPsd;
+  if ((it != m_channelGainMatrix.end ()) && (generation != 0) && (it->second.prefetchedGeneration == generation))
+    {
+      chPsd = Copy<SpectrumValue> (rxPsd);
+      ApplySubbandGains (chPsd, it->second.prefetchedGains);
     }
   else
     {
-      /* The channel has already been computed */
-      chPsd = (*it).second;
+      chPsd = GetChannelGain (rxPsd, channel, txCodebook, rxCodebook, txPattern, rxPattern);
     }
-
+  if (it == m_channelGainMatrix.end ())
+    {
+      if ((m_channelGainCacheSize > 0) && (m_channelGainMatrix.size () >= m_channelGainCacheSize))
+        {
+          /* Evict the least recently used link configuration */
+          m_channelGainMatrix.erase (m_channelGainLru.back ());
+          m_channelGainLru.pop_back ();
+        }
+      m_channelGainLru.push_front (key);
+      it = m_channelGainMatrix.insert (std::make_pair (key, ChannelGainEntry ())).first;
+      ChannelGainEntry &entry = it->second;
+      entry.lru = m_channelGainLru.begin ();
+      entry.lastUsed = m_currentIndex;
+      entry.indexTx = indexTx;
+      entry.indexRx = indexRx;
+      entry.txCodebook = txCodebook;
+      entry.rxCodebook = rxCodebook;
+      entry.txPattern = txPattern;
+      entry.rxPattern = rxPattern;
+    }
+  it->second.rxPsd = rxPsd;
+  it->second.gain = chPsd;
+  it->second.generation = generation;
+  std::vector<double> ().swap (it->second.prefetchedGains);
+  it->second.prefetchedGeneration = 0;
   return chPsd;
 }
 
-void
-QdPropagationEngine::CalcMimoRxPower (Ptr<SpectrumSignalParameters> params,
-                                      Ptr<const MobilityModel> a,
-                                      Ptr<const MobilityModel> b) const
+Ptr<const QdDeviceHandle>
+QdPropagationEngine::GetDeviceHandle (Ptr<const MobilityModel> mobility) const
 {
-  uint32_t indexTx, indexRx;
+  QdDeviceHandleMap::iterator it = m_deviceHandles.find (mobility);
+  if (it != m_deviceHandles.end ())
+    {
+      return it->second;
+    }
+  Ptr<QdDeviceHandle> handle = Create<QdDeviceHandle> ();
+  handle->device = mobility->GetObject<Node> ()->GetDevice (0);
+  Ptr<WifiNetDevice> wifiDevice = DynamicCast<WifiNetDevice> (handle->device);
+  handle->phy = StaticCast<SpectrumDmgWifiPhy> (wifiDevice->GetPhy ());
+  handle->codebook = DynamicCast<CodebookParametric> (handle->phy->GetCodebook ());
+  handle->nodeId = handle->device->GetNode ()->GetId ();
+  m_deviceHandles.insert (std::make_pair (mobility, handle));
+  return handle;
+}
 
-  Ptr<DmgWifiSpectrumSignalParameters> rxParams = DynamicCast<DmgWifiSpectrumSignalParameters> (params);
+Ptr<const QdDeviceHandle>
+QdPropagationEngine::GetTransmitter (Ptr<DmgWifiSpectrumSignalParameters> params,
+                                     Ptr<const MobilityModel> a) const
+{
+  if (params->qdTransmitter != 0)
+    {
+      return params->qdTransmitter;
+    }
 
-  Ptr<NetDevice> txDevice = a->GetObject<Node> ()->GetDevice (0);
-  Ptr<NetDevice> rxDevice = b->GetObject<Node> ()->GetDevice (0);
+  /* Mobility Management */
+  HandleMobility ();
+  return GetDeviceHandle (a);
+}
 
-  Ptr<WifiNetDevice> wifiTxDevice = DynamicCast<WifiNetDevice> (txDevice);
-  Ptr<SpectrumDmgWifiPhy> txSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiTxDevice->GetPhy ());
-  Ptr<CodebookParametric> txCodebook = DynamicCast<CodebookParametric> (txSpectrum->GetCodebook ());
+void
+QdPropagationEngine::PrepareTransmission (Ptr<SpectrumSignalParameters> params) const
+{
+  NS_LOG_FUNCTION (this << params);
+  Ptr<DmgWifiSpectrumSignalParameters> txParams = DynamicCast<DmgWifiSpectrumSignalParameters> (params);
+  if (txParams == 0)
+    {
+      return;
+    }
 
-  Ptr<WifiNetDevice> wifiRxDevice = DynamicCast<WifiNetDevice> (rxDevice);
-  Ptr<SpectrumDmgWifiPhy> rxSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiRxDevice->GetPhy ());
-  Ptr<CodebookParametric> rxCodebook = DynamicCast<CodebookParametric> (rxSpectrum->GetCodebook ());
+  /* Mobility Management */
+  HandleMobility ();
+  txParams->qdTransmitter = GetDeviceHandle (params->txPhy->GetMobility ());
+}
 
+uint32_t
+QdPropagationEngine::GetQdIndex (const QdDeviceHandle &handle) const
+{
   if (m_useCustomIDs)
     {
-      indexTx = GetQdID (txDevice->GetNode ()->GetId ());
-      indexRx = GetQdID (rxDevice->GetNode ()->GetId ());
+      return GetQdID (handle.nodeId);
     }
   else
     {
-      indexTx = txDevice->GetNode ()->GetId ();
-      indexRx = rxDevice->GetNode ()->GetId ();
+      return handle.nodeId;
     }
+}
 
-  /* Mobility Management */
-  HandleMobility ();
+Ptr<SpectrumValue>
+QdPropagationEngine::CalcRxPower (Ptr<SpectrumSignalParameters> params,
+				  Ptr<const MobilityModel> a,
+				  Ptr<const MobilityModel> b) const
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<DmgWifiSpectrumSignalParameters> rxParams = DynamicCast<DmgWifiSpectrumSignalParameters> (params);
+
+  Ptr<const QdDeviceHandle> tx = GetTransmitter (rxParams, a);
+  Ptr<const QdDeviceHandle> rx = GetDeviceHandle (b);
+  uint32_t indexTx = GetQdIndex (*tx);
+  uint32_t indexRx = GetQdIndex (*rx);
+
+  /* The receive pattern is the one in use when the signal arrives */
+  Ptr<PatternConfig> rxPattern = rx->codebook->GetRxPatternConfig ();
+
+  LinkConfiguration key = GetLinkConfiguration (tx->device, rx->device,
+                                                 std::make_pair (rxParams->antennaId, rxParams->txPatternConfig),
+                                                 std::make_pair (rx->codebook->GetActiveAntennaID (), rxPattern),
+                                                 rxParams->psd);
+  Ptr<SpectrumValue> chPsd = GetCachedChannelGain (key, indexTx, indexRx, rxParams->psd,
+                                                   tx->codebook, rx->codebook,
+                                                   rxParams->txPatternConfig, rxPattern);
+
+  /* A SISO receiver only needs the received power within its RF filter, which is cached
+   * together with the gain so that it is integrated once per link configuration */
+  ChannelGainEntry &entry = m_channelGainMatrix.find (key)->second;
+  Ptr<SpectrumValue> rxFilter = rx->phy->GetRfFilter ();
+  if ((entry.filteredGain != chPsd) || (entry.rxFilter != rxFilter))
+    {
+      entry.filteredPowerW = SpectrumDmgWifiPhy::IntegrateOverFilter (rxFilter, chPsd);
+      entry.filteredGain = chPsd;
+      entry.rxFilter = rxFilter;
+    }
+  rxParams->filteredRxPowerW = entry.filteredPowerW;
+  return chPsd;
+}
+
+void
+QdPropagationEngine::CalcMimoRxPower (Ptr<SpectrumSignalParameters> params,
+                                      Ptr<const MobilityModel> a,
+                                      Ptr<const MobilityModel> b) const
+{
+  Ptr<DmgWifiSpectrumSignalParameters> rxParams = DynamicCast<DmgWifiSpectrumSignalParameters> (params);
+  Ptr<const QdDeviceHandle> tx = GetTransmitter (rxParams, a);
+  Ptr<const QdDeviceHandle> rx = GetDeviceHandle (b);
+  Ptr<NetDevice> txDevice = tx->device;
+  Ptr<NetDevice> rxDevice = rx->device;
+  Ptr<CodebookParametric> txCodebook = tx->codebook;
+  Ptr<CodebookParametric> rxCodebook = rx->codebook;
+  uint32_t indexTx = GetQdIndex (*tx);
+  uint32_t indexRx = GetQdIndex (*rx);
 
 //  for (auto const &txConfig : txCodebook->GetActiveTxPatternIDs ())
 //    {
@@ -667,114 +1009,65 @@ QdPropagationEngine::CalcMimoRxPower (Ptr<SpectrumSignalParameters> params,
     {
       for (auto const &rxAntenna : rxCodebook->GetActiveRxPatternList ())
         {
-          AntennaConfigTx antennaConfigTx = std::make_pair (txAntenna.first, txAntenna.second);
-          AntennaConfigRx antennaConfigRx = std::make_pair (rxAntenna.first, rxAntenna.second);
-          LinkConfiguration key = std::make_tuple (txDevice, rxDevice, antennaConfigTx, antennaConfigRx);
-
-          ChannelGainMatrix_I it = m_channelGainMatrix.find (key);
-          Ptr<SpectrumValue> chPsd;
-
-          /* Check if the channel has already been computed between transmitter and receiver for certain antenna configurations */
-          if (it == m_channelGainMatrix.end ())
-            {
-              QdChanneldentifier chId = std::make_tuple (indexTx, indexRx, m_currentIndex, txAntenna.first, rxAntenna.first);
-              uint16_t pathNum = nbMultipathTxRx[chId];
-
-              /* Doppler effect */
-              if (m_interval.IsStrictlyPositive ())
-                {
-                  floatVector_t dopplerShiftVec;
-                  for (uint16_t i = 0; i < pathNum; i++)
-                    {
-                      dopplerShiftVec.push_back (m_uniformRv->GetValue (0, 1));
-                    }
-                  dopplerShiftTxRx[chId] = dopplerShiftVec;
-                }
-
-              /*
-               * Insert the channel into the Channel matrix to avoid
-               * recomputing the channel every time if there is no Mobility.
-               */
-              chPsd = GetChannelGain (rxParams->psd, pathNum, chId,
-                                      txCodebook, rxCodebook,
-                                      txAntenna.second, rxAntenna.second);
-              m_channelGainMatrix[key] = chPsd;
-            }
-          else
-            {
-              /* The channel has already been computed */
-              chPsd = (*it).second;
-            }
+          LinkConfiguration key = GetLinkConfiguration (txDevice, rxDevice, txAntenna, rxAntenna, rxParams->psd);
+          Ptr<SpectrumValue> chPsd = GetCachedChannelGain (key, indexTx, indexRx, rxParams->psd,
+                                                           txCodebook, rxCodebook,
+                                                           txAntenna.second, rxAntenna.second);
           rxParams->psdList.push_back (chPsd);
         }
     }
 }
 
-AnglesTransformed
-QdPropagationEngine::GetTransformedAngles (double elevation, double azimuth, bool isDoa, float2DVector_t& rotmVector) const
+/**
+ * Get the azimuth and elevation angles of a direction vector after its rotation.
+ * \param doa The rotated direction vector.
+ * \return The angles of the direction vector in degrees.
+ */
+static AnglesTransformed
+GetDirectionAngles (float doa[3])
 {
-  float doa[1][3];
-  float doa_temp[1][3];
-  int m1 = 1;
-  int m2 = 3;
-  int n2 = 3;
-
-  doa_temp[0][0] = sin (elevation) * cos (azimuth);
-  doa_temp[0][1] = sin (elevation) * sin (azimuth);
-  doa_temp[0][2] = cos (elevation);
-
-  for (int i = 0; i < m1; i++)
-    {
-      for (int j = 0; j < n2; j++)
-        {
-          doa[i][j] = 0;
-          for (int x = 0; x < m2; x++)
-            {
-              *(*(doa + i) + j) += *(*(doa_temp + i) + x) * rotmVector[x][j];
-            }
-        }
-    }
+  double azimuth, elevation;
 
   // Truncate because of the float problem
-  if (doa[0][0] <= 0.00001 && doa[0][0] >= 0)
+  if (doa[0] <= 0.00001 && doa[0] >= 0)
     {
-      doa[0][0] = 0;
+      doa[0] = 0;
     }
-  if (doa[0][0] >= - 0.00001 && doa[0][0] <= 0)
+  if (doa[0] >= - 0.00001 && doa[0] <= 0)
     {
-      doa[0][0] = 0;
+      doa[0] = 0;
     }
-  if (doa[0][1] <= 0.00001 && doa[0][1] >= 0)
+  if (doa[1] <= 0.00001 && doa[1] >= 0)
     {
-      doa[0][1] = 0;
+      doa[1] = 0;
     }
-  if (doa[0][1] >= - 0.00001 && doa[0][1] <= 0)
+  if (doa[1] >= - 0.00001 && doa[1] <= 0)
     {
-      doa[0][1] = 0;
+      doa[1] = 0;
     }
-  if ((doa[0][0] == doa[0][1]) && doa[0][0] == 0)
+  if ((doa[0] == doa[1]) && doa[0] == 0)
     {
       azimuth = 0;
     }
-  else if (doa[0][1] < 0 && doa[0][0] >=0)
+  else if (doa[1] < 0 && doa[0] >=0)
     {
-      azimuth = 2*M_PI + atan (doa[0][1]/doa[0][0]);
+      azimuth = 2*M_PI + atan (doa[1]/doa[0]);
     }
-  else if (doa[0][1] <= 0 && doa[0][0] < 0)
+  else if (doa[1] <= 0 && doa[0] < 0)
     {
-      azimuth = M_PI + atan (doa[0][1]/doa[0][0]);
+      azimuth = M_PI + atan (doa[1]/doa[0]);
     }
-  else if (doa[0][1]>0 && doa[0][0]<0)
+  else if (doa[1]>0 && doa[0]<0)
     {
-      azimuth = M_PI + atan (doa[0][1]/doa[0][0]);
+      azimuth = M_PI + atan (doa[1]/doa[0]);
     }
   else
     {
-      azimuth = atan (doa[0][1]/doa[0][0]);
+      azimuth = atan (doa[1]/doa[0]);
     }
 
   azimuth *= 180/M_PI;
-  elevation = acos (doa[0][2]) * 180/M_PI;
+  elevation = acos (doa[2]) * 180/M_PI;
 
   AnglesTransformed angles;
   angles.elevation = round (elevation);
@@ -783,9 +1076,61 @@ QdPropagationEngine::GetTransformedAngles (double elevation, double azimuth, boo
 }
 
 void
-QdPropagationEngine::EulerTransform (Orientation orientation, float2DVector_t& rotMatrix) const
+QdPropagationEngine::TransformAngles (const float *elevations, const float *azimuths, uint16_t numPaths,
+                                      const RotationMatrix &rotMatrix,
+                                      uint16_t *transformedElevations, uint16_t *transformedAzimuths) const
+{
+  /* Rotate the direction vector of every multipath component first. The rotation is a fixed
+   * sequence of multiply-adds over contiguous arrays, which the compiler vectorizes. */
+  std::vector<float> directions (3 * numPaths);
+  float *x = directions.data ();
+  float *y = x + numPaths;
+  float *z = y + numPaths;
+  for (uint16_t k = 0; k < numPaths; k++)
+    {
+      double elevation = float (DegreesToRadians (elevations[k]));
+      double azimuth = float (DegreesToRadians (azimuths[k]));
+      x[k] = sin (elevation) * cos (azimuth);
+      y[k] = sin (elevation) * sin (azimuth);
+      z[k] = cos (elevation);
+    }
+  for (uint16_t k = 0; k < numPaths; k++)
+    {
+      float dx = x[k];
+      float dy = y[k];
+      float dz = z[k];
+      x[k] = dx * rotMatrix.value[0][0] + dy * rotMatrix.value[1][0] + dz * rotMatrix.value[2][0];
+      y[k] = dx * rotMatrix.value[0][1] + dy * rotMatrix.value[1][1] + dz * rotMatrix.value[2][1];
+      z[k] = dx * rotMatrix.value[0][2] + dy * rotMatrix.value[1][2] + dz * rotMatrix.value[2][2];
+    }
+
+  /* Convert the rotated directions back to angles */
+  for (uint16_t k = 0; k < numPaths; k++)
+    {
+      float doa[3] = {x[k], y[k], z[k]};
+      AnglesTransformed angles = GetDirectionAngles (doa);
+      transformedElevations[k] = angles.elevation;
+      transformedAzimuths[k] = angles.azimuth;
+    }
+}
+
+const RotationMatrix &
+QdPropagationEngine::GetRotationMatrix (const Orientation &orientation) const
+{
+  OrientationKey key = std::make_tuple (orientation.psi, orientation.theta, orientation.phi);
+  RotationMatrixMap::iterator it = m_rotationMatrices.find (key);
+  if (it == m_rotationMatrices.end ())
+    {
+      it = m_rotationMatrices.insert (std::make_pair (key, RotationMatrix ())).first;
+      EulerTransform (orientation, it->second);
+    }
+  return it->second;
+}
+
+void
+QdPropagationEngine::EulerTransform (const Orientation &orientation, RotationMatrix &rotMatrix) const
 {
-  float rotm[3][3];     // Rotation matrix.
+  float (&rotm)[3][3] = rotMatrix.value;
 
   rotm[0][0] = cos (orientation.psi) * cos (orientation.theta);
   rotm[0][1] = cos (orientation.psi) * sin (orientation.theta) * sin (orientation.phi) - sin (orientation.psi) * cos (orientation.phi);
@@ -798,16 +1143,6 @@ QdPropagationEngine::EulerTransform (Orientation orientation, float2DVector_t& r
   rotm[2][0] = -sin (orientation.theta);
   rotm[2][1] = cos (orientation.theta) * sin (orientation.phi);
   rotm[2][2] = cos (orientation.theta) * cos (orientation.phi);
-
-  for (uint8_t i = 0; i < 3 ; i++)
-    {
-      floatVector_t rotmRow;
-      for (uint8_t j = 0; j < 3; j++)
-        {
-          rotmRow.push_back (rotm[i][j]);
-        }
-      rotMatrix.push_back (rotmRow);
-    }
 }
 
 } // namespace ns3
@@ -32,6 +32,7 @@
 #define QD_PROPAGATION_ENGINE_H
 
 #include <ns3/angles.h>
+#include <ns3/core-config.h>
 #include <ns3/mobility-model.h>
 #include <ns3/net-device.h>
 #include <ns3/net-device-container.h>
@@ -39,12 +40,18 @@
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/spectrum-signal-parameters.h>
 #include <ns3/spectrum-value.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#endif
 
 #include <complex>
+#include <list>
 #include <map>
 #include <tuple>
+#include <unordered_map>
 
 #include "codebook-parametric.h"
+#include "qd-channel-store.h"
 
 namespace ns3 {
 
@@ -52,13 +59,59 @@ typedef std::vector<float> floatVector_t;
 typedef std::vector<floatVector_t> float2DVector_t;
 
 /**
- * A unique identifier for the Q-D channel trace.
- * SRC Node ID, Destination Node ID, Q-D TraceIndex, Tx Antenna ID, Rx Antenna ID.
+ * Multipath parameters of a Q-D channel realization between one Tx antenna and one Rx antenna
+ * for a given trace index. The parameters are stored as a structure of arrays, so a single lookup
+ * gives access to all the multipath components and computing the channel gain streams through
+ * contiguous memory. Delay, path gain and phase reference the Q-D file image directly, while the
+ * angles are transformed into the coordinate system of each phased antenna array when loading.
  */
-typedef std::tuple<uint32_t, uint32_t, uint32_t, AntennaID, AntennaID> QdChanneldentifier;
-typedef std::map<QdChanneldentifier, floatVector_t> ChannelCoefficientMap;
-typedef ChannelCoefficientMap::iterator ChannelCoefficientMap_I;
-typedef ChannelCoefficientMap::iterator ChannelCoefficientMap_CI;
+struct QdChannelParameters {
+  uint16_t numPaths;                    //!< The number of multipath components.
+  const float *delay;                   //!< Delay of each multipath component in seconds.
+  const float *pathLoss;                //!< Path gain (dB).
+  const float *phase;                   //!< Phase (radians).
+  std::vector<uint16_t> angles;         //!< Transformed AoD azimuth, AoD elevation, AoA azimuth and AoA elevation (Degrees).
+  uint32_t generation;                  //!< Identifier shared by consecutive traces with identical parameters.
+
+  /**
+   * \return The AoD azimuth of each multipath component in the Tx antenna coordinate system.
+   */
+  const uint16_t *GetAodAzimuth (void) const { return angles.data (); }
+  /**
+   * \return The AoD elevation of each multipath component in the Tx antenna coordinate system.
+   */
+  const uint16_t *GetAodElevation (void) const { return angles.data () + numPaths; }
+  /**
+   * \return The AoA azimuth of each multipath component in the Rx antenna coordinate system.
+   */
+  const uint16_t *GetAoaAzimuth (void) const { return angles.data () + 2 * numPaths; }
+  /**
+   * \return The AoA elevation of each multipath component in the Rx antenna coordinate system.
+   */
+  const uint16_t *GetAoaElevation (void) const { return angles.data () + 3 * numPaths; }
+};
+
+/**
+ * Doppler effect of a distinct Q-D channel realization. The Doppler shifts are drawn when the
+ * Q-D channel is loaded and the phase is evaluated at the start of the first trace of the
+ * realization, so the gain of a link does not depend on when or how often it is computed.
+ */
+struct QdDopplerEffect {
+  floatVector_t shift;                  //!< Normalized Doppler shift of each multipath component.
+  double time;                          //!< The time (s) at which the Doppler phase is evaluated.
+};
+
+/**
+ * All the Q-D channel realizations between a pair of nodes, indexed by
+ * trace index, Tx antenna and Rx antenna (same order as in the Q-D files).
+ */
+struct QdChannelPair {
+  Ptr<QdChannelStore> store;                    //!< The Q-D file image the parameters refer to.
+  uint8_t numTxAntennas;                        //!< The number of Tx antennas.
+  uint8_t numRxAntennas;                        //!< The number of Rx antennas.
+  uint32_t numTraces;                           //!< The number of traces in the Q-D file.
+  std::vector<QdChannelParameters> channels;    //!< The multipath parameters of each channel realization.
+};
 
 /**
  * The transformed angles after rounding the double values.
@@ -68,16 +121,121 @@ struct AnglesTransformed {
   uint16_t azimuth;
 };
 
+/**
+ * Rotation matrix associated with the orientation of a phased antenna array.
+ */
+struct RotationMatrix {
+  float value[3][3];    //!< The coefficients of the matrix, row by row.
+};
+typedef std::tuple<double, double, double> OrientationKey;                     //!< Typedef for the Euler angles (psi, theta, phi) of an orientation.
+typedef std::map<OrientationKey, RotationMatrix> RotationMatrixMap;             //!< Typedef for the rotation matrices of the orientations in use.
+
 typedef std::pair<AntennaID, Ptr<PatternConfig> > AntennaConfig;                //!< Generic antenna array configuration pair.
 typedef AntennaConfig AntennaConfigTx;                                          //!< Transmit phased antenna array configuration pair.
 typedef AntennaConfig AntennaConfigRx;                                          //!< Receive phased antenna array configuration pair.
-typedef std::tuple<Ptr<NetDevice>, Ptr<NetDevice>, AntennaConfigTx, AntennaConfigRx> LinkConfiguration; //!< Link Configuration key.
-typedef std::map<LinkConfiguration, Ptr<SpectrumValue> > ChannelGainMatrix;     //!< Channel gain matrix defining channel gain for all the possible combinations in the scenario.
+
+/**
+ * Compact key identifying a link configuration in the channel gain cache.
+ */
+struct LinkConfiguration {
+  uint32_t txNode;                      //!< The ID of the Tx node.
+  uint32_t rxNode;                      //!< The ID of the Rx node.
+  AntennaID txAntenna;                  //!< The ID of the Tx antenna.
+  AntennaID rxAntenna;                  //!< The ID of the Rx antenna.
+  uint32_t txPattern;                   //!< The ID of the Tx pattern configuration (0 if none).
+  uint32_t rxPattern;                   //!< The ID of the Rx pattern configuration (0 if none).
+  SpectrumModelUid_t spectrumModel;     //!< The UID of the spectrum model of the received signal.
+
+  /**
+   * \param other The link configuration to compare with.
+   * \return True if both keys identify the same link configuration.
+   */
+  bool operator == (const LinkConfiguration &other) const;
+};
+
+/**
+ * Hash function for the channel gain cache keys.
+ */
+struct LinkConfigurationHash {
+  /**
+   * \param key The link configuration.
+   * \return The hash of the link configuration.
+   */
+  size_t operator () (const LinkConfiguration &key) const;
+};
+
+typedef std::list<LinkConfiguration> LinkConfigurationList;                     //!< Typedef for the cached link configurations ordered by recency of use.
+
+/**
+ * Channel gain cached for a link configuration.
+ */
+struct ChannelGainEntry {
+  Ptr<SpectrumValue> gain;              //!< The received PSD computed for the link configuration.
+  uint32_t generation;                  //!< The generation of the Q-D channel the gain was computed from.
+  uint32_t lastUsed;                    //!< The last trace index during which the link configuration was used.
+  LinkConfigurationList::iterator lru;  //!< Position of the link configuration in the LRU list.
+  /* Inputs needed to compute the gain of the link configuration for another trace */
+  Ptr<SpectrumValue> rxPsd;             //!< The PSD of the transmitted signal.
+  uint32_t indexTx;                     //!< The Q-D ID of the Tx node.
+  uint32_t indexRx;                     //!< The Q-D ID of the Rx node.
+  Ptr<CodebookParametric> txCodebook;   //!< The codebook of the Tx device.
+  Ptr<CodebookParametric> rxCodebook;   //!< The codebook of the Rx device.
+  Ptr<PatternConfig> txPattern;         //!< The transmit pattern configuration.
+  Ptr<PatternConfig> rxPattern;         //!< The receive pattern configuration.
+  /* Subband gains prefetched for a later Q-D channel realization, applied when first used */
+  std::vector<double> prefetchedGains;  //!< Complex gain of each subband (interleaved real and imaginary parts).
+  uint32_t prefetchedGeneration;        //!< The generation of the Q-D channel the gains were prefetched for (0 if none).
+  /* Received power of the gain integrated over the RF filter of the receiver (SISO reception) */
+  Ptr<const SpectrumValue> filteredGain;  //!< The gain the filtered power was computed from.
+  Ptr<const SpectrumValue> rxFilter;      //!< The RF filter the filtered power was computed with.
+  double filteredPowerW;                  //!< The gain integrated over the RF filter in W.
+};
+
+typedef std::unordered_map<LinkConfiguration, ChannelGainEntry, LinkConfigurationHash> ChannelGainMatrix; //!< Channel gain cache for the link configurations in the scenario.
 typedef ChannelGainMatrix::iterator ChannelGainMatrix_I;                        //!< Typedef for iterator over channel gain matrix.
-typedef ChannelGainMatrix::const_iterator ChannelMatrix_CI;                     //!< Typedef for constant iterator over channel matrix.
+
+/**
+ * Channel gain of a link configuration computed ahead of a trace boundary.
+ */
+struct QdPrefetchTask {
+  LinkConfiguration key;                                //!< The link configuration.
+  uint32_t generation;                                  //!< The generation of the Q-D channel in the next trace.
+  std::vector<std::complex<double> > amplitudes;        //!< Complex amplitude of each multipath component.
+  floatVector_t delays;                                 //!< Delay of each multipath component in seconds.
+  std::vector<double> frequencies;                      //!< Center frequency of each subband in Hz.
+  std::vector<double> gains;                            //!< Complex gain of each subband (interleaved real and imaginary parts).
+};
+
+/**
+ * Channel gains of the active links computed for the next trace. The job only accesses
+ * its own tasks, so it can run in a worker thread while the simulation goes on.
+ */
+struct QdPrefetchJob : public SimpleRefCount<QdPrefetchJob> {
+  uint32_t traceIndex;                  //!< The trace index the channel gains are computed for.
+  std::vector<QdPrefetchTask> tasks;    //!< The channel gains to compute.
+
+  /**
+   * Compute the subband gains of all the tasks.
+   */
+  void Run (void);
+};
+class SpectrumDmgWifiPhy;
+
+/**
+ * Handles of the device of a node, resolved once from the mobility model of the node
+ * instead of looking up the device, the PHY and the codebook for every received signal.
+ */
+struct QdDeviceHandle : public SimpleRefCount<QdDeviceHandle> {
+  Ptr<NetDevice> device;                //!< The first net device of the node.
+  Ptr<SpectrumDmgWifiPhy> phy;          //!< The spectrum DMG PHY of the device.
+  Ptr<CodebookParametric> codebook;     //!< The parametric codebook of the PHY.
+  uint32_t nodeId;                      //!< The ID of the node.
+};
+typedef std::map<Ptr<const MobilityModel>, Ptr<QdDeviceHandle> > QdDeviceHandleMap; //!< Typedef for the device handles of each mobility model.
+
 typedef std::pair<uint32_t, uint32_t> CommunicatingPair;                        //!< Typedef for identifying communicating pair.
-typedef std::vector<CommunicatingPair> TraceFiles;                              //!< Check whether trace files have been loaded or not.
-typedef TraceFiles::iterator TraceFiles_I;                                      //!< Typedef for iterator over traces files.
+typedef std::map<CommunicatingPair, QdChannelPair> QdChannelPairMap;            //!< Typedef for the Q-D channels loaded for each communicating pair.
+typedef QdChannelPairMap::iterator QdChannelPairMap_I;                          //!< Typedef for iterator over the loaded Q-D channels.
 
 class NodeContainer;
 struct DmgWifiSpectrumSignalParameters;
@@ -138,6 +296,14 @@ protected:
    * \return The propagation delay between two devices/antennas in Seconds.
    */
   Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+  /**
+   * Prepare a transmission before it is delivered to its receivers. The Q-D trace index is
+   * updated and the handles of the transmitting device are stored in the signal parameters,
+   * so each receiver only resolves itself and its receive pattern when the signal arrives.
+   *
+   * \param params the SpectrumSignalParameters of the transmitted signal.
+   */
+  void PrepareTransmission (Ptr<SpectrumSignalParameters> params) const;
   /**
    * This method is to be called to calculate PSD at the receiver side.
    *
@@ -170,29 +336,112 @@ private:
    * Handle mobility by changing Q-D trace index.
    */
   void HandleMobility (void) const;
+  /**
+   * Get the handles of the device of a node. The handles are resolved the first time
+   * the mobility model of the node is encountered.
+   * \param mobility The mobility model of the node.
+   * \return The handles of the device of the node.
+   */
+  Ptr<const QdDeviceHandle> GetDeviceHandle (Ptr<const MobilityModel> mobility) const;
+  /**
+   * Get the handles of the transmitting device of a signal. When the transmission has not been
+   * prepared, the handles are resolved and the Q-D trace index is updated for this reception.
+   * \param params the signal parameters of the reception.
+   * \param a The mobility model of the transmitting node.
+   * \return The handles of the transmitting device.
+   */
+  Ptr<const QdDeviceHandle> GetTransmitter (Ptr<DmgWifiSpectrumSignalParameters> params,
+                                            Ptr<const MobilityModel> a) const;
+  /**
+   * Get the ID used for reading the Q-D files of a device.
+   * \param handle The handles of the device.
+   * \return The Q-D ID of the device.
+   */
+  uint32_t GetQdIndex (const QdDeviceHandle &handle) const;
 
   /**
    * Initialize Q-D Channel model parameters.
-   * \param a Mobility model of the transmitter.
-   * \param b Mobility model of the receivers.
+   * \param tx The handles of the Tx device.
+   * \param rx The handles of the Rx device.
    * \param indexTx The ID of the Tx node.
    * \param indexRx The ID of the Rx node.
    */
-  void InitializeQDModelParameters (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b,
+  void InitializeQDModelParameters (const QdDeviceHandle &tx, const QdDeviceHandle &rx,
                                     uint16_t indexTx, uint16_t indexRx) const;
+  /**
+   * Get the multipath parameters of a Q-D channel realization.
+   * \param indexTx The ID of the Tx node.
+   * \param indexRx The ID of the Rx node.
+   * \param traceIndex The index of the trace in the Q-D file.
+   * \param txAntenna The ID of the Tx antenna.
+   * \param rxAntenna The ID of the Rx antenna.
+   * \return Pointer to the multipath parameters or 0 if the channel has not been loaded.
+   */
+  QdChannelParameters *GetChannelParameters (uint32_t indexTx, uint32_t indexRx, uint32_t traceIndex,
+                                             AntennaID txAntenna, AntennaID rxAntenna) const;
+  /**
+   * Build the channel gain cache key of a link configuration.
+   * \param txDevice The Tx device.
+   * \param rxDevice The Rx device.
+   * \param txConfig The Tx antenna and pattern configuration.
+   * \param rxConfig The Rx antenna and pattern configuration.
+   * \param rxPsd The received power spectral density.
+   * \return The key of the link configuration.
+   */
+  LinkConfiguration GetLinkConfiguration (Ptr<NetDevice> txDevice, Ptr<NetDevice> rxDevice,
+                                          const AntennaConfigTx &txConfig, const AntennaConfigRx &rxConfig,
+                                          Ptr<const SpectrumValue> rxPsd) const;
+  /**
+   * Get the channel gain of a link configuration, either from the channel gain cache or by
+   * computing it when it is missing or was computed for a different Q-D channel realization.
+   * \param key The link configuration.
+   * \param indexTx The Q-D ID of the Tx node.
+   * \param indexRx The Q-D ID of the Rx node.
+   * \param rxPsd The received power spectral density.
+   * \param txCodebook Pointer to the codebook of the Tx device.
+   * \param rxCodebook Pointer to the codebook of the Rx device.
+   * \param txPattern Pointer to the transmit pattern configuration.
+   * \param rxPattern Pointer to the receive pattern configuration
+   * \return Channel gain between Tx and Tx device as Spectrum Value.
+   */
+  Ptr<SpectrumValue> GetCachedChannelGain (const LinkConfiguration &key, uint32_t indexTx, uint32_t indexRx,
+                                           Ptr<SpectrumValue> rxPsd,
+                                           Ptr<CodebookParametric> txCodebook, Ptr<CodebookParametric> rxCodebook,
+                                           Ptr<PatternConfig> txPattern, Ptr<PatternConfig> rxPattern) const;
+  /**
+   * Start computing the channel gains of the next trace for the links used during a given trace.
+   * \param activeIndex The trace index during which the links must have been used.
+   */
+  void StartPrefetch (uint32_t activeIndex) const;
+  /**
+   * Wait for the channel gains being prefetched and hand them over to the channel gain cache
+   * if they have been computed for the current trace.
+   */
+  void FinishPrefetch (void) const;
+  /**
+   * Compute the part of the gain of each multipath component that does not depend on the subband.
+   * \param channel The multipath parameters between Tx and Rx devices/antennas.
+   * \param txCodebook Pointer to the codebook of the Tx device.
+   * \param rxCodebook Pointer to the codebook of the Rx device.
+   * \param txPattern Pointer to the transmit pattern configuration.
+   * \param rxPattern Pointer to the receive pattern configuration
+   * \param amplitudes The complex amplitude of each multipath component.
+   */
+  void ComputePathAmplitudes (const QdChannelParameters *channel,
+                              Ptr<CodebookParametric> txCodebook, Ptr<CodebookParametric> rxCodebook,
+                              Ptr<PatternConfig> txPattern, Ptr<PatternConfig> rxPattern,
+                              std::vector<std::complex<double> > &amplitudes) const;
   /**
    * Compute the channel gain between two devices or antennas.
    * \param rxPsd The received power spectral density.
-   * \param pathNum The number of multipath components between Tx and Rx devices/antennas.
-   * \param chId Q-D channel profile identifier.
+   * \param channel The multipath parameters between Tx and Rx devices/antennas (0 if there is no channel).
    * \param txCodebook Pointer to the codebook of the Tx device.
    * \param rxCodebook Pointer to the codebook of the Rx device.
    * \param txPattern Pointer to the transmit pattern configuration.
    * \param rxPattern Pointer to the receive pattern configuration
    * \return Channel gain between Tx and Tx device as Spectrum Value.
    */
-  Ptr<SpectrumValue> GetChannelGain (Ptr<SpectrumValue> rxPsd,
-                                     uint16_t pathNum, QdChanneldentifier chId,
+  Ptr<SpectrumValue> GetChannelGain (Ptr<SpectrumValue> rxPsd, const QdChannelParameters *channel,
                                      Ptr<CodebookParametric> txCodebook, Ptr<CodebookParametric> rxCodebook,
                                      Ptr<PatternConfig> txPattern, Ptr<PatternConfig> rxPattern) const;
   /**
@@ -200,16 +449,25 @@ private:
    * \param orientation The orienation of the phased antenna array using Euler angles.
    * \param rotMatrix Rotation matrix corresponding to the euler transformation.
    */
-  void EulerTransform (Orientation orientation, float2DVector_t& rotMatrix) const;
+  void EulerTransform (const Orientation &orientation, RotationMatrix &rotMatrix) const;
   /**
-   * Transform angles using the rotation vector obtained from the quaternion transformation.
-   * \param elevation The elevation angle in radians.
-   * \param azimuth The azimuth angle in radians.
-   * \param isDoa Flag to indicate if it is direction of arrival.
-   * \param rotmVector Rotation vectors.
-   * \return The transformed angles in the new coordinate system measured in degree.
+   * Get the rotation matrix of an antenna orientation. The matrix of each orientation is computed once.
+   * \param orientation The orienation of the phased antenna array using Euler angles.
+   * \return The rotation matrix corresponding to the euler transformation.
    */
-  AnglesTransformed GetTransformedAngles (double elevation, double azimuth, bool isDoa, float2DVector_t& rotmVector) const;
+  const RotationMatrix & GetRotationMatrix (const Orientation &orientation) const;
+  /**
+   * Transform the angles of all the multipath components of a channel using a rotation matrix.
+   * \param elevations The elevation angle of each multipath component in degrees (Q-D coordinate system).
+   * \param azimuths The azimuth angle of each multipath component in degrees (Q-D coordinate system).
+   * \param numPaths The number of multipath components.
+   * \param rotMatrix The rotation matrix of the antenna orientation.
+   * \param transformedElevations The transformed elevation angle of each multipath component in degrees.
+   * \param transformedAzimuths The transformed azimuth angle of each multipath component in degrees.
+   */
+  void TransformAngles (const float *elevations, const float *azimuths, uint16_t numPaths,
+                        const RotationMatrix &rotMatrix,
+                        uint16_t *transformedElevations, uint16_t *transformedAzimuths) const;
   /**
    * Set Q-D Channel model folder path.
    * \param folderName The path to the Q-D Channel files.
@@ -222,24 +480,27 @@ private:
   void SetStartIndex (const uint32_t startIndex);
 
 private:
-  mutable ChannelGainMatrix m_channelGainMatrix;//!< Channel matrix for the whole communication network.
+  mutable ChannelGainMatrix m_channelGainMatrix;//!< Channel gain cache for the whole communication network.
+  mutable LinkConfigurationList m_channelGainLru;//!< Cached link configurations, the most recently used first.
+  uint32_t m_channelGainCacheSize;              //!< The maximum number of entries in the channel gain cache.
+  mutable uint64_t m_channelGainCacheHits;      //!< The number of channel gains served from the cache.
+  mutable uint64_t m_channelGainCacheMisses;    //!< The number of channel gains computed.
+  mutable uint32_t m_nextGeneration;            //!< The generation assigned to the next distinct Q-D channel realization.
+  mutable std::vector<QdDopplerEffect> m_dopplerEffects;//!< Doppler effect of each Q-D channel realization, indexed by generation.
+  bool m_prefetch;                              //!< Flag to indicate whether the channel gains of the next trace are prefetched.
+  mutable Ptr<QdPrefetchJob> m_prefetchJob;     //!< The channel gains being prefetched.
+#ifdef HAVE_PTHREAD_H
+  mutable Ptr<SystemThread> m_prefetchThread;   //!< The worker thread computing the prefetched channel gains.
+#endif
   std::string m_qdFolder;                       //!< Folder that contains all the Q-D Channel model files.
   Ptr<UniformRandomVariable> m_uniformRv;       //!< Uniform random variable for doppler.
   Time m_interval;                              //!< The interval between two consecutive traces.
   uint32_t m_startIndex;                        //!< Starting point in a Q-D file.
   mutable uint32_t m_currentIndex;              //!< Current index in the trace file.
-  mutable TraceFiles m_traceFiles;              //!< Status of the traces files.
   mutable uint32_t m_numTraces;                 //!< The number of traces in Q-D files.
-
-  mutable std::map<QdChanneldentifier, uint32_t>  nbMultipathTxRx;      //!< Number of multipaths components.
-  mutable ChannelCoefficientMap                   delayTxRx;            //!< Delay spread in ns.
-  mutable ChannelCoefficientMap                   pathLossTxRx;         //!< PathLoss (dB).
-  mutable ChannelCoefficientMap                   phaseTxRx;            //!< Phase (radians).
-  mutable ChannelCoefficientMap                   dopplerShiftTxRx;     //!< Doppler shift in Hz.
-  mutable ChannelCoefficientMap                   aodAzimuthTxRx;       //!< AoD Azimuth (Degrees).
-  mutable ChannelCoefficientMap                   aodElevationTxRx;     //!< AoD Elevation (Degrees).
-  mutable ChannelCoefficientMap                   aoaElevationTxRx;     //!< AoA Elevation (Degrees).
-  mutable ChannelCoefficientMap                   aoaAzimuthTxRx;       //!< AoA Azimuth (Degrees).
+  mutable QdChannelPairMap m_channelPairs;      //!< Q-D channels loaded for each communicating pair.
+  mutable RotationMatrixMap m_rotationMatrices; //!< Rotation matrices of the antenna orientations.
+  mutable QdDeviceHandleMap m_deviceHandles;    //!< Device handles of the nodes, indexed by their mobility model.
 
   std::map<uint32_t, uint32_t> nodeId2QdId; //!< Structure to map node ID to Q-D Channel ID.
   bool m_useCustomIDs;                      //!< Flag to indicate whether we use custom list to map ns-3 nodes IDs to Q-D Software IDs.
@@ -81,6 +81,12 @@ QdPropagationLossModel::DoCalculateRxPowerAtReceiverSide (void) const
   return true;
 }
 
+void
+QdPropagationLossModel::PrepareTransmission (Ptr<SpectrumSignalParameters> params) const
+{
+  m_qdPropagationEngine->PrepareTransmission (params);
+}
+
 Ptr<SpectrumValue>
 QdPropagationLossModel::CalcRxPower (Ptr<SpectrumSignalParameters> params,
 				     Ptr<const MobilityModel> a,
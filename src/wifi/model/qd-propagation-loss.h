@@ -67,6 +67,12 @@ private:
    * \return Return true if we store we calculate the received power at the receiver side, otherwise false.
    */
   bool DoCalculateRxPowerAtReceiverSide (void) const;
+  /**
+   * Resolve the transmitter and update the Q-D trace index once per transmission.
+   *
+   * \param params the SpectrumSignalParameters of the transmitted signal.
+   */
+  virtual void PrepareTransmission (Ptr<SpectrumSignalParameters> params) const;
   /**
    * This method is to be called to calculate PSD at the receiver side.
    *
@@ -13,6 +13,19 @@ NS_LOG_COMPONENT_DEFINE ("RFChain");
 
 NS_OBJECT_ENSURE_REGISTERED (RFChain);
 
+uint32_t PatternConfig::s_nextPatternId = 1;
+
+PatternConfig::PatternConfig ()
+  : m_patternId (s_nextPatternId++)
+{
+}
+
+PatternConfig::PatternConfig (const PatternConfig &config)
+  : SimpleRefCount<PatternConfig> (config),
+    m_patternId (s_nextPatternId++)
+{
+}
+
 /**
  * We need this destructor for the
  */
@@ -20,6 +33,19 @@ PatternConfig::~PatternConfig ()
 {
 }
 
+PatternConfig &
+PatternConfig::operator = (const PatternConfig &config)
+{
+  /* A copy describes a different pattern, so it keeps its own identifier */
+  return *this;
+}
+
+uint32_t
+PatternConfig::GetPatternId (void) const
+{
+  return m_patternId;
+}
+
 void
 PhasedAntennaArrayConfig::SetQuasiOmniConfig (Ptr<PatternConfig> quasiPattern)
 {
@@ -42,7 +42,20 @@ enum BeamRefinementType {
  * Generic Radiation Pattern Configuration.
  */
 struct PatternConfig : public SimpleRefCount<PatternConfig> {
+  PatternConfig ();
+  PatternConfig (const PatternConfig &config);
   virtual ~PatternConfig ();
+  PatternConfig & operator = (const PatternConfig &config);
+  /**
+   * Get the unique identifier of this pattern configuration. Identifiers are never reused,
+   * so they can be used instead of pointers as compact keys for caching channel gains.
+   * \return The identifier of the pattern configuration (starting from 1).
+   */
+  uint32_t GetPatternId (void) const;
+
+private:
+  uint32_t m_patternId;                 //!< The unique identifier of the pattern configuration.
+  static uint32_t s_nextPatternId;      //!< The identifier assigned to the next pattern configuration.
 };
 
 /**
@@ -3,7 +3,28 @@
 
 namespace ns3 {
 
-double sensitivity_ber(unsigned int index);
+/**
+ * The number of entries in the sensitivity lookup table, covering offsets of the
+ * received signal strength from the receiver sensitivity between -12 dB and +6 dB
+ * in steps of 0.1 dB.
+ */
+static const unsigned int SENSITIVITY_LUT_SIZE = 181;
+
+/**
+ * Sensitivity lookup table. Each entry holds the offset (dB) of the received signal
+ * strength from the receiver sensitivity and the corresponding bit error rate.
+ */
+extern const double sensitivity_matrix[SENSITIVITY_LUT_SIZE][2];
+
+/**
+ * \param index the index of the entry in the sensitivity lookup table.
+ * \return the bit error rate of the entry.
+ */
+inline double
+sensitivity_ber (unsigned int index)
+{
+  return sensitivity_matrix[index][1];
+}
 
 }
 
@@ -20,7 +20,7 @@
 #include "ns3/log.h"
 #include "ns3/interference-helper.h"
 
-#include "wifi-phy.h"
+#include "dmg-wifi-phy.h"
 #include "sensitivity-model-60-ghz.h"
 #include "sensitivity-lut.h"
 
@@ -28,6 +28,28 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("SensitivityModel60GHz");
 
+/**
+ * Receiver sensitivity (dBm) of the DMG MCSs indexed by MCS.
+ */
+static constexpr double DMG_SENSITIVITY[] = {
+  -78,                                                          /* Control PHY */
+  -68, -66, -65, -64, -62, -63, -62, -61, -59, -55, -54, -53,   /* SC PHY */
+  -66, -64, -63, -62, -60, -58, -56, -54, -53, -51, -49, -47,   /* OFDM PHY */
+  -64, -60, -57, -57, -57, -57, -57,                            /* Low power PHY */
+};
+
+/**
+ * Receiver sensitivity (dBm) of the EDMG SC MCSs indexed by MCS, 0 if the MCS has no sensitivity.
+ */
+static constexpr double EDMG_SC_SENSITIVITY[] = {
+  0, -68, -66, -65, -64, -62, 0, -63, -62, -61, -59, 0, -55, -54, -53,
+};
+
+/**
+ * Receiver sensitivity (dBm) of the EDMG Control PHY.
+ */
+static constexpr double EDMG_CTRL_SENSITIVITY = -78;
+
 NS_OBJECT_ENSURE_REGISTERED (SensitivityModel60GHz);
 
 TypeId
@@ -44,6 +66,57 @@ SensitivityModel60GHz::SensitivityModel60GHz ()
 {
 }
 
+double
+SensitivityModel60GHz::GetSensitivity (WifiMode mode) const
+{
+  uint32_t uid = mode.GetUid ();
+  if (uid >= m_sensitivity.size ())
+    {
+      m_sensitivity.resize (uid + 1, 0);
+    }
+  if (m_sensitivity[uid] != 0)
+    {
+      return m_sensitivity[uid];
+    }
+
+  /* Only the standard MCSs of each modulation class have a sensitivity */
+  double sensitivity = 0;
+  uint8_t mcs = mode.GetMcsValue ();
+  switch (mode.GetModulationClass ())
+    {
+    case WIFI_MOD_CLASS_DMG_CTRL:
+    case WIFI_MOD_CLASS_DMG_SC:
+    case WIFI_MOD_CLASS_DMG_OFDM:
+    case WIFI_MOD_CLASS_DMG_LP_SC:
+      if ((mcs < sizeof (DMG_SENSITIVITY) / sizeof (double)) && (mode == DmgWifiPhy::GetDmgMcs (mcs)))
+        {
+          sensitivity = DMG_SENSITIVITY[mcs];
+        }
+      break;
+    case WIFI_MOD_CLASS_EDMG_CTRL:
+      if (mode == DmgWifiPhy::GetEdmgMcs (WIFI_MOD_CLASS_EDMG_CTRL, mcs))
+        {
+          sensitivity = EDMG_CTRL_SENSITIVITY;
+        }
+      break;
+    case WIFI_MOD_CLASS_EDMG_SC:
+      if ((mcs < sizeof (EDMG_SC_SENSITIVITY) / sizeof (double))
+          && (mode == DmgWifiPhy::GetEdmgMcs (WIFI_MOD_CLASS_EDMG_SC, mcs)))
+        {
+          sensitivity = EDMG_SC_SENSITIVITY[mcs];
+        }
+      break;
+    default:
+      break;
+    }
+  if (sensitivity == 0)
+    {
+      NS_FATAL_ERROR ("Unrecognized 60 GHz modulation");
+    }
+  m_sensitivity[uid] = sensitivity;
+  return sensitivity;
+}
+
 double
 SensitivityModel60GHz::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const
 {
@@ -54,7 +127,6 @@ SensitivityModel60GHz::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector
     mode.GetModulationClass () == WIFI_MOD_CLASS_EDMG_SC ||
     mode.GetModulationClass () == WIFI_MOD_CLASS_EDMG_OFDM,
     "Expecting 802.11ad DMG CTRL, SC or OFDM modulation or 802.11ay EDMG CTRL, SC or OFDM modulation");
-  std::string modename = mode.GetUniqueName ();
 
   /* This is kinda silly, but convert from SNR back to RSS (Hardcoding RxNoiseFigure)*/
   //thermal noise at 290K in J/s = W
@@ -63,83 +135,9 @@ SensitivityModel60GHz::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector
 
   /* Compute RSS in dBm, so add 30 from SNR */
   double rss = 10 * log10 (snr * noise) + 30;
-  double rss_delta;
+  double rss_delta = rss - GetSensitivity (mode);
   double ber;
 
-  /**** Control PHY ****/
-  if (modename == "DMG_MCS0" || modename == "EDMG_MCS0")
-    rss_delta = rss - -78;
-
-  /**** SC PHY ****/
-  else if (modename == "DMG_MCS1" || modename == "EDMG_SC_MCS1")
-    rss_delta = rss - -68;
-  else if (modename == "DMG_MCS2" || modename == "EDMG_SC_MCS2")
-    rss_delta = rss - -66;
-  else if (modename == "DMG_MCS3" || modename == "EDMG_SC_MCS3")
-    rss_delta = rss - -65;
-  else if (modename == "DMG_MCS4" || modename == "EDMG_SC_MCS4")
-    rss_delta = rss - -64;
-  else if (modename == "DMG_MCS5" || modename == "EDMG_SC_MCS5")
-    rss_delta = rss - -62;
-  else if (modename == "DMG_MCS6" || modename == "EDMG_SC_MCS7")
-    rss_delta = rss - -63;
-  else if (modename == "DMG_MCS7" || modename == "EDMG_SC_MCS8")
-    rss_delta = rss - -62;
-  else if (modename == "DMG_MCS8" || modename == "EDMG_SC_MCS9")
-    rss_delta = rss - -61;
-  else if (modename == "DMG_MCS9" || modename == "EDMG_SC_MCS10")
-    rss_delta = rss - -59;
-  else if (modename == "DMG_MCS10" || modename == "EDMG_SC_MCS12")
-    rss_delta = rss - -55;
-  else if (modename == "DMG_MCS11" || modename == "EDMG_SC_MCS13")
-    rss_delta = rss - -54;
-  else if (modename == "DMG_MCS12" || modename == "EDMG_SC_MCS14")
-    rss_delta = rss - -53;
-
-  /**** OFDM PHY ****/
-  else if (modename == "DMG_MCS13")
-    rss_delta = rss - -66;
-  else if (modename == "DMG_MCS14")
-    rss_delta = rss - -64;
-  else if (modename == "DMG_MCS15")
-    rss_delta = rss - -63;
-  else if (modename == "DMG_MCS16")
-    rss_delta = rss - -62;
-  else if (modename == "DMG_MCS17")
-    rss_delta = rss - -60;
-  else if (modename == "DMG_MCS18")
-    rss_delta = rss - -58;
-  else if (modename == "DMG_MCS19")
-    rss_delta = rss - -56;
-  else if (modename == "DMG_MCS20")
-    rss_delta = rss - -54;
-  else if (modename == "DMG_MCS21")
-    rss_delta = rss - -53;
-  else if (modename == "DMG_MCS22")
-    rss_delta = rss - -51;
-  else if (modename == "DMG_MCS23")
-    rss_delta = rss - -49;
-  else if (modename == "DMG_MCS24")
-    rss_delta = rss - -47;
-
-  /**** Low power PHY ****/
-  else if (modename == "DMG_MCS25")
-    rss_delta = rss - -64;
-  else if (modename == "DMG_MCS26")
-    rss_delta = rss - -60;
-  else if (modename == "DMG_MCS27")
-    rss_delta = rss - -57;
-  else if (modename == "DMG_MCS28")
-    rss_delta = rss - -57;
-  else if (modename == "DMG_MCS29")
-    rss_delta = rss - -57;
-  else if (modename == "DMG_MCS30")
-    rss_delta = rss - -57;
-  else if (modename == "DMG_MCS31")
-    rss_delta = rss - -57;
-  else
-    NS_FATAL_ERROR("Unrecognized 60 GHz modulation");
-
   /* Compute BER in lookup table */
   if ((rss_delta < -12.0) || (snr < 0))
     ber = sensitivity_ber (0);
@@ -18,6 +18,7 @@
 #define SENSITIVITY_MODEL_60_GHZ
 
 #include <stdint.h>
+#include <vector>
 #include "wifi-mode.h"
 #include "error-rate-model.h"
 
@@ -31,6 +32,17 @@ public:
   SensitivityModel60GHz ();
 
   virtual double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const;
+
+private:
+  /**
+   * Get the receiver sensitivity of a 60 GHz WifiMode. The sensitivity is looked up in
+   * the sensitivity tables the first time the mode is used and cached by its UID.
+   * \param mode the Wi-Fi mode.
+   * \return the receiver sensitivity of the mode in dBm.
+   */
+  double GetSensitivity (WifiMode mode) const;
+
+  mutable std::vector<double> m_sensitivity;  //!< Receiver sensitivity (dBm) of each WifiMode indexed by its UID, 0 if not resolved yet.
 };
 
 } // namespace ns3
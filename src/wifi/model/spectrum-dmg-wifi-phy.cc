@@ -31,6 +31,7 @@
 #include "ns3/node.h"
 #include "spectrum-dmg-wifi-phy.h"
 #include "dmg-wifi-spectrum-phy-interface.h"
+#include "qd-propagation-engine.h"
 #include "wifi-utils.h"
 #include "wifi-ppdu.h"
 #include "wifi-psdu.h"
@@ -43,6 +44,7 @@ NS_LOG_COMPONENT_DEFINE ("SpectrumDmgWifiPhy");
 NS_OBJECT_ENSURE_REGISTERED (SpectrumDmgWifiPhy);
 
 DmgWifiSpectrumSignalParameters::DmgWifiSpectrumSignalParameters ()
+  : filteredRxPowerW (-1)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -56,6 +58,12 @@ DmgWifiSpectrumSignalParameters::DmgWifiSpectrumSignalParameters (const DmgWifiS
   txVector = p.txVector;
   antennaId = p.antennaId;
   txPatternConfig = p.txPatternConfig;
+  filteredRxPowerW = p.filteredRxPowerW;
+  qdTransmitter = p.qdTransmitter;
+}
+
+DmgWifiSpectrumSignalParameters::~DmgWifiSpectrumSignalParameters ()
+{
 }
 
 Ptr<SpectrumSignalParameters>
@@ -92,6 +100,9 @@ SpectrumDmgWifiPhy::GetTypeId (void)
 }
 
 SpectrumDmgWifiPhy::SpectrumDmgWifiPhy ()
+  : m_rfFilterFrequency (0),
+    m_rfFilterChannelWidth (0),
+    m_rfFilterGuardBandwidth (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -107,6 +118,8 @@ SpectrumDmgWifiPhy::DoDispose (void)
   NS_LOG_FUNCTION (this);
   m_channel = 0;
   m_wifiSpectrumPhyInterface = 0;
+  m_txPsdCache.clear ();
+  m_rfFilter = 0;
   DmgWifiPhy::DoDispose ();
 }
 
@@ -222,13 +235,49 @@ SpectrumDmgWifiPhy::ConfigureStandard (WifiPhyStandard standard)
     }
 }
 
+Ptr<SpectrumValue>
+SpectrumDmgWifiPhy::GetRfFilter (void)
+{
+  uint16_t frequency = GetFrequency ();
+  uint16_t channelWidth = GetChannelWidth ();
+  uint16_t guardBandwidth = GetGuardBandwidth ();
+  if ((m_rfFilter == 0) || (frequency != m_rfFilterFrequency)
+      || (channelWidth != m_rfFilterChannelWidth) || (guardBandwidth != m_rfFilterGuardBandwidth))
+    {
+      NS_LOG_DEBUG ("Creating RF filter for frequency/width/guard of (" << frequency << ", "
+                    << channelWidth << ", " << guardBandwidth << ")");
+      m_rfFilter = WifiSpectrumValueHelper::CreateRfFilter (frequency, channelWidth,
+                                                            WIGIG_OFDM_SUBCARRIER_SPACING, guardBandwidth);
+      m_rfFilterFrequency = frequency;
+      m_rfFilterChannelWidth = channelWidth;
+      m_rfFilterGuardBandwidth = guardBandwidth;
+    }
+  return m_rfFilter;
+}
+
+double
+SpectrumDmgWifiPhy::IntegrateOverFilter (Ptr<const SpectrumValue> filter, Ptr<const SpectrumValue> psd)
+{
+  NS_ASSERT (filter->GetSpectrumModelUid () == psd->GetSpectrumModelUid ());
+  /* Same operations and summation order as Integral ((*filter) * (*psd)) */
+  double power = 0;
+  Values::const_iterator fit = filter->ConstValuesBegin ();
+  Values::const_iterator vit = psd->ConstValuesBegin ();
+  for (Bands::const_iterator bit = psd->ConstBandsBegin (); bit != psd->ConstBandsEnd (); bit++, fit++, vit++)
+    {
+      double value = (*fit) * (*vit);
+      power += value * (bit->fh - bit->fl);
+    }
+  return power;
+}
+
 double
 SpectrumDmgWifiPhy::FilterSignal (Ptr<SpectrumValue> filter, Ptr<SpectrumValue> receivedSignalPsd)
 {
-  SpectrumValue filteredSignal = (*filter) * (*receivedSignalPsd);
+  double filteredPowerW = IntegrateOverFilter (filter, receivedSignalPsd);
   // Add receiver antenna gain
-  NS_LOG_DEBUG ("Signal power received (watts) before antenna gain: " << Integral (filteredSignal));
-  double rxPowerW = Integral (filteredSignal) * DbToRatio (GetRxGain ());
+  NS_LOG_DEBUG ("Signal power received (watts) before antenna gain: " << filteredPowerW);
+  double rxPowerW = filteredPowerW * DbToRatio (GetRxGain ());
   NS_LOG_DEBUG ("Signal power received after antenna gain: " << rxPowerW << " W (" << WToDbm (rxPowerW) << " dBm)");
   return rxPowerW;
 }
@@ -249,9 +298,8 @@ SpectrumDmgWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
   // Integrate over our receive bandwidth (i.e., all that the receive
   // spectral mask representing our filtering allows) to find the
   // total energy apparent to the "demodulator".
-  uint16_t channelWidth = GetChannelWidth ();
-  Ptr<SpectrumValue> filter = WifiSpectrumValueHelper::CreateRfFilter (GetFrequency (), channelWidth,
-                                                                       WIGIG_OFDM_SUBCARRIER_SPACING, GetGuardBandwidth ());
+  Ptr<SpectrumValue> filter = GetRfFilter ();
+  Ptr<DmgWifiSpectrumSignalParameters> wifiRxParams = DynamicCast<DmgWifiSpectrumSignalParameters> (rxParams);
   double rxPowerW;
   std::vector<double> rxPowerList;
   if (rxParams->psdList.size () > 0)
@@ -262,6 +310,12 @@ SpectrumDmgWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
         }
       rxPowerW = *std::max_element(rxPowerList.begin (), rxPowerList.end ());
     }
+  else if (wifiRxParams && (wifiRxParams->filteredRxPowerW >= 0))
+    {
+      /* The propagation loss model already integrated the received PSD over our RF filter */
+      rxPowerW = wifiRxParams->filteredRxPowerW * DbToRatio (GetRxGain ());
+      rxPowerList.push_back (rxPowerW);
+    }
   else
     {
       rxPowerW = FilterSignal (filter, receivedSignalPsd);
@@ -275,8 +329,6 @@ SpectrumDmgWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
 //      std::cout << "MIMO: " << WToDbm (FilterSignal (filter, psd)) << std::endl;
 //    }
 
-  Ptr<DmgWifiSpectrumSignalParameters> wifiRxParams = DynamicCast<DmgWifiSpectrumSignalParameters> (rxParams);
-
   // Log the signal arrival to the trace source
   m_signalCb (wifiRxParams ? true : false, senderNodeId, WToDbm (rxPowerW), rxDuration);
 
@@ -305,7 +357,8 @@ SpectrumDmgWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
   if ((wifiRxParams->plcpFieldType == PLCP_80211AD_PREAMBLE_HDR_DATA) || (wifiRxParams->plcpFieldType == PLCP_80211AY_PREAMBLE_HDR_DATA))
     {
       NS_LOG_INFO ("Received DMG/EDMG WiFi signal");
-      Ptr<WifiPpdu> ppdu = Copy (wifiRxParams->ppdu);
+      /* The PPDU is not modified once handed over to the channel, so all the receivers share it */
+      Ptr<WifiPpdu> ppdu = wifiRxParams->ppdu;
       if (rxParams->psdList.size () > 0)
         {
           NS_LOG_INFO ("Received EDMG WiFi signal in MIMO mode");
@@ -372,6 +425,15 @@ SpectrumDmgWifiPhy::GetTxPowerSpectralDensity (uint16_t centerFrequency, uint16_
                                                double txPowerW, WifiModulationClass modulationClass) const
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << modulationClass);
+  /* The PSD only depends on the key parameters and is never modified once handed over to the channel,
+   * so the same SpectrumValue is shared by every transmission with identical parameters. */
+  TxPsdKey key (centerFrequency, channelWidth, GetGuardBandwidth (), m_channelConfiguration.NCB,
+                modulationClass, txPowerW);
+  TxPsdMap::const_iterator it = m_txPsdCache.find (key);
+  if (it != m_txPsdCache.end ())
+    {
+      return it->second;
+    }
   Ptr<SpectrumValue> v;
   switch (modulationClass)
     {
@@ -396,6 +458,7 @@ SpectrumDmgWifiPhy::GetTxPowerSpectralDensity (uint16_t centerFrequency, uint16_
       NS_FATAL_ERROR ("modulation class unknown: " << modulationClass);
       break;
     }
+  m_txPsdCache[key] = v;
   return v;
 }
 
@@ -31,11 +31,14 @@
 #include "codebook-parametric.h"
 #include "dmg-wifi-phy.h"
 #include "wifi-phy.h"
+#include <map>
+#include <tuple>
 
 namespace ns3 {
 
 class DmgWifiSpectrumPhyInterface;
 class WifiPpdu;
+struct QdDeviceHandle;
 
 /**
  * \ingroup wifi
@@ -57,6 +60,7 @@ struct DmgWifiSpectrumSignalParameters : public SpectrumSignalParameters
    * \param p the object to copy from.
    */
   DmgWifiSpectrumSignalParameters (const DmgWifiSpectrumSignalParameters& p);
+  virtual ~DmgWifiSpectrumSignalParameters ();
 
   /**
    * The packet being transmitted with this signal
@@ -78,6 +82,16 @@ struct DmgWifiSpectrumSignalParameters : public SpectrumSignalParameters
    * Pointer to the active Tx pattern configuration.
    */
   Ptr<PatternConfig> txPatternConfig;
+  /**
+   * Received power integrated over the RF filter of the receiver, before the receiver
+   * antenna gain, in W. Negative when it has to be computed from the received PSD.
+   */
+  double filteredRxPowerW;
+  /**
+   * Handles of the transmitting device, resolved once per transmission by the Q-D
+   * propagation engine. Null when the signal does not go through the engine.
+   */
+  Ptr<const QdDeviceHandle> qdTransmitter;
 };
 
 /**
@@ -163,6 +177,19 @@ public:
    * channel width).
    */
   uint16_t GetGuardBandwidth (void) const;
+  /**
+   * Get the RF filter matching the current frequency, channel width and guard bandwidth.
+   * The filter is rebuilt only when one of these parameters changes.
+   * \return Pointer to the RF filter.
+   */
+  Ptr<SpectrumValue> GetRfFilter (void);
+  /**
+   * Integrate a power spectral density over an RF filter without materializing the filtered PSD.
+   * \param filter The RF filter.
+   * \param psd The power spectral density.
+   * \return The power in W within the filter.
+   */
+  static double IntegrateOverFilter (Ptr<const SpectrumValue> filter, Ptr<const SpectrumValue> psd);
 
   /**
    * Callback invoked when the PHY model starts to process a signal
@@ -247,6 +274,18 @@ private:
   bool m_disableWifiReception;                              //!< forces this PHY to fail to sync on any signal
   TracedCallback<bool, uint32_t, double, Time> m_signalCb;  //!< Signal callback
 
+  /**
+   * Key of a cached TX PSD: center frequency, channel width, guard bandwidth,
+   * number of bonded channels, modulation class and TX power in W.
+   */
+  typedef std::tuple<uint16_t, uint16_t, uint16_t, uint8_t, WifiModulationClass, double> TxPsdKey;
+  typedef std::map<TxPsdKey, Ptr<SpectrumValue> > TxPsdMap;
+  mutable TxPsdMap m_txPsdCache;                            //!< Cache of the TX PSDs built by this PHY.
+  Ptr<SpectrumValue> m_rfFilter;                            //!< Cached RF filter.
+  uint16_t m_rfFilterFrequency;                             //!< Center frequency (MHz) of the cached RF filter.
+  uint16_t m_rfFilterChannelWidth;                          //!< Channel width (MHz) of the cached RF filter.
+  uint16_t m_rfFilterGuardBandwidth;                        //!< Guard bandwidth (MHz) of the cached RF filter.
+
 };
 
 } //namespace ns3
@@ -2268,8 +2268,9 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
 {
   WifiMode payloadMode = txVector.GetMode ();
   NS_LOG_FUNCTION (size << payloadMode);
+  WifiModulationClass modClass = payloadMode.GetModulationClass ();
 
-  if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_DMG_CTRL)
+  if (modClass == WIFI_MOD_CLASS_DMG_CTRL)
     {
       uint32_t Ncw;                       /* Number of LDPC codewords. */
       uint32_t Ldpcw;                     /* Number of bits in the second and any subsequent codeword except the last. */
@@ -2290,7 +2291,7 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
 
       return NanoSeconds (ceil (ret));
     }
-  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_DMG_LP_SC)
+  else if (modClass == WIFI_MOD_CLASS_DMG_LP_SC)
     {
       //        uint32_t Nbits = (size * 8);  /* Number of bits in the payload part. */
       //        uint32_t Nrsc;                /* The total number of Reed Solomon codewords */
@@ -2323,19 +2324,21 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
       //        Nblks = (uint32_t) ceil(neb/());
       return NanoSeconds (0);
     }
-  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_DMG_SC)
+  else if (modClass == WIFI_MOD_CLASS_DMG_SC)
     {
       /* 21.3.4 Timeing Related Parameters, Table 21-4 TData = (Nblks * 512 + 64) * Tc. */
       /* 21.6.3.2.3.3 (4), Compute Nblks = The number of symbol blocks. */
 
+      uint16_t constellationSize = payloadMode.GetConstellationSize ();
+      WifiCodeRate codeRate = payloadMode.GetCodeRate ();
       uint32_t Ncbpb; // Ncbpb = Number of coded bits per symbol block. Check Table 21-20 for different constellations.
-      if (payloadMode.GetConstellationSize () == 2)
+      if (constellationSize == 2)
         Ncbpb = 448;
-      else if (payloadMode.GetConstellationSize () == 4)
+      else if (constellationSize == 4)
         Ncbpb = 2 * 448;
-      else if (payloadMode.GetConstellationSize () == 16)
+      else if (constellationSize == 16)
         Ncbpb = 4 * 448;
-      else if (payloadMode.GetConstellationSize () == 64)
+      else if (constellationSize == 64)
         Ncbpb = 6 * 448;
       else
         NS_FATAL_ERROR ("unsupported constellation size");
@@ -2343,23 +2346,23 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
       uint32_t Nbits = (size * 8); /* Nbits = Number of bits in the payload part. */
       uint32_t Ncbits;             /* Ncbits = Number of coded bits in the payload part. */
 
-      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_4)
+      if (codeRate == WIFI_CODE_RATE_1_4)
         Ncbits = Nbits * 4;
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_2)
+      else if (codeRate == WIFI_CODE_RATE_1_2)
         Ncbits = Nbits * 2;
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_13_16)
+      else if (codeRate == WIFI_CODE_RATE_13_16)
         Ncbits = (uint32_t) ceil (double (Nbits) * 16.0 / 13);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_3_4)
+      else if (codeRate == WIFI_CODE_RATE_3_4)
         Ncbits = (uint32_t) ceil (double (Nbits) * 4.0 / 3);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_8)
+      else if (codeRate == WIFI_CODE_RATE_5_8)
         Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 5);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_7_8)
+      else if (codeRate == WIFI_CODE_RATE_7_8)
         Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 7);
       else
         NS_FATAL_ERROR ("unsupported code rate");
 
       uint16_t Lcw; /* The LDPC codeword length. */
-      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_7_8)
+      if (codeRate == WIFI_CODE_RATE_7_8)
         Lcw = 624;
       else
         Lcw = 672;
@@ -2381,19 +2384,21 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
         }
       return NanoSeconds (tData);
     }
-  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_DMG_OFDM)
+  else if (modClass == WIFI_MOD_CLASS_DMG_OFDM)
     {
       /* 21.3.4 Timeing Related Parameters, Table 21-4 TData = Nsym * Tsys(OFDM) */
       /* 21.5.3.2.3.3 (5), Compute Nsym = Number of OFDM Symbols */
 
+      uint16_t constellationSize = payloadMode.GetConstellationSize ();
+      WifiCodeRate codeRate = payloadMode.GetCodeRate ();
       uint32_t Ncbps; // Ncbps = Number of coded bits per symbol. Check Table 21-20 for different constellations.
-      if (payloadMode.GetConstellationSize () == 2)
+      if (constellationSize == 2)
         Ncbps = 336;
-      else if (payloadMode.GetConstellationSize () == 4)
+      else if (constellationSize == 4)
         Ncbps = 2 * 336;
-      else if (payloadMode.GetConstellationSize () == 16)
+      else if (constellationSize == 16)
         Ncbps = 4 * 336;
-      else if (payloadMode.GetConstellationSize () == 64)
+      else if (constellationSize == 64)
         Ncbps = 6 * 336;
       else
         NS_FATAL_ERROR ("unsupported constellation size");
@@ -2401,15 +2406,15 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
       uint32_t Nbits = (size * 8); /* Nbits = Number of bits in the payload part. */
       uint32_t Ncbits;             /* Ncbits = Number of coded bits in the payload part. */
 
-      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_4)
+      if (codeRate == WIFI_CODE_RATE_1_4)
         Ncbits = Nbits * 4;
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_2)
+      else if (codeRate == WIFI_CODE_RATE_1_2)
         Ncbits = Nbits * 2;
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_13_16)
+      else if (codeRate == WIFI_CODE_RATE_13_16)
         Ncbits = (uint32_t) ceil (double (Nbits) * 16.0 / 13);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_3_4)
+      else if (codeRate == WIFI_CODE_RATE_3_4)
         Ncbits = (uint32_t) ceil (double (Nbits) * 4.0 / 3);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_8)
+      else if (codeRate == WIFI_CODE_RATE_5_8)
         Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 5);
       else
         NS_FATAL_ERROR ("unsupported code rate");
@@ -2429,7 +2434,7 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
         }
       return NanoSeconds (tData);
     }
-  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_EDMG_CTRL)
+  else if (modClass == WIFI_MOD_CLASS_EDMG_CTRL)
     {
       uint32_t Ncw;                       /* Number of LDPC codewords. */
       uint32_t Ldpcw;                     /* Number of bits in the second and any subsequent codeword except the last. */
@@ -2452,7 +2457,7 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
 
       return NanoSeconds (ceil (ret));
     }
-  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_EDMG_SC)
+  else if (modClass == WIFI_MOD_CLASS_EDMG_SC)
     {
       /* 29.12.3.3 TXTIME calculation for EDMG SC mode, TData = (Nblks * 512 + Ngi) * Tc. */
       /* 29.5.9.4 (d4), Compute Nblks = The number of symbol blocks. */
@@ -2470,14 +2475,16 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
         NS_FATAL_ERROR ("Unsupported guard interval length");
 
       // For now we are assuming that the same MCS is used for all STS
+      uint16_t constellationSize = payloadMode.GetConstellationSize ();
+      WifiCodeRate codeRate = payloadMode.GetCodeRate ();
       uint32_t Ncbps; // Ncbps = Number of coded bits per symbol. Check Table 21-20 for different constellations.
-      if (payloadMode.GetConstellationSize () == 2)
+      if (constellationSize == 2)
         Ncbps = 1;
-      else if (payloadMode.GetConstellationSize () == 4)
+      else if (constellationSize == 4)
         Ncbps = 2;
-      else if (payloadMode.GetConstellationSize () == 16)
+      else if (constellationSize == 16)
         Ncbps = 4;
-      else if (payloadMode.GetConstellationSize () == 64)
+      else if (constellationSize == 64)
         Ncbps = 6;
       else
         NS_FATAL_ERROR ("unsupported constellation size");
@@ -2487,28 +2494,28 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
       uint32_t Nbits = (size * 8); /* Nbits = Number of bits in the payload part. */
       uint32_t Ncbits;             /* Ncbits = Number of coded bits in the payload part. */
 
-      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_4)
+      if (codeRate == WIFI_CODE_RATE_1_4)
         Ncbits = Nbits * 4;
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_2)
+      else if (codeRate == WIFI_CODE_RATE_1_2)
         Ncbits = Nbits * 2;
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_13_16)
+      else if (codeRate == WIFI_CODE_RATE_13_16)
         Ncbits = (uint32_t) ceil (double (Nbits) * 16.0 / 13);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_3_4)
+      else if (codeRate == WIFI_CODE_RATE_3_4)
         Ncbits = (uint32_t) ceil (double (Nbits) * 4.0 / 3);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_8)
+      else if (codeRate == WIFI_CODE_RATE_5_8)
         Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 5);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_7_8)
+      else if (codeRate == WIFI_CODE_RATE_7_8)
         Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 7);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_2_3)
+      else if (codeRate == WIFI_CODE_RATE_2_3)
         Ncbits = (uint32_t) ceil (double (Nbits) * 3.0 / 2);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_6)
+      else if (codeRate == WIFI_CODE_RATE_5_6)
         Ncbits = (uint32_t) ceil (double (Nbits) * 6.0 / 5);
       else
         NS_FATAL_ERROR ("unsupported code rate");
 
       uint16_t Lcw; /* The LDPC codeword length. */
 
-      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_2_3 || payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_6)
+      if (codeRate == WIFI_CODE_RATE_2_3 || codeRate == WIFI_CODE_RATE_5_6)
         Lcw = 504;
       else
         Lcw = 672;
@@ -2554,7 +2561,7 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
 
       return NanoSeconds (tData);
     }
-  else if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_EDMG_OFDM)
+  else if (modClass == WIFI_MOD_CLASS_EDMG_OFDM)
     {
       /* 29.12.3.4 TXTIME calculation for EDMG OFDM mode, TData = (Nsym * (512 + Ngi)) * Ts */
       /* 21.5.3.2.3.3 (5), Compute Nsym = Number of OFDM Symbols */
@@ -2574,14 +2581,16 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
         NS_FATAL_ERROR("Unsupported number of continous channels");
 
       // Once multimple space-time streams are enabled - sum the Nbpsc for all space-time streams.
+      uint16_t constellationSize = payloadMode.GetConstellationSize ();
+      WifiCodeRate codeRate = payloadMode.GetCodeRate ();
       uint32_t Nbpsc; // Nbpsc = Number of coded bits per constellation point Check Table 115 (ayD4) for different constellations.
-      if (payloadMode.GetConstellationSize () == 2)
+      if (constellationSize == 2)
         Nbpsc = 1;
-      else if (payloadMode.GetConstellationSize () == 4)
+      else if (constellationSize == 4)
         Nbpsc = 2;
-      else if (payloadMode.GetConstellationSize () == 16)
+      else if (constellationSize == 16)
         Nbpsc = 4;
-      else if (payloadMode.GetConstellationSize () == 64)
+      else if (constellationSize == 64)
         Nbpsc = 6;
       else
         NS_FATAL_ERROR ("unsupported constellation size");
@@ -2595,15 +2604,15 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
       uint32_t Nbits = (size * 8); /* Nbits = Number of bits in the payload part. */
       uint32_t Ncbits;             /* Ncbits = Number of coded bits in the payload part. */
 
-      if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_1_2)
+      if (codeRate == WIFI_CODE_RATE_1_2)
         Ncbits = Nbits * 2;
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_7_8)
+      else if (codeRate == WIFI_CODE_RATE_7_8)
         Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 7);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_13_16)
+      else if (codeRate == WIFI_CODE_RATE_13_16)
         Ncbits = (uint32_t) ceil (double (Nbits) * 16.0 / 13);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_3_4)
+      else if (codeRate == WIFI_CODE_RATE_3_4)
         Ncbits = (uint32_t) ceil (double (Nbits) * 4.0 / 3);
-      else if (payloadMode.GetCodeRate () == WIFI_CODE_RATE_5_8)
+      else if (codeRate == WIFI_CODE_RATE_5_8)
         Ncbits = (uint32_t) ceil (double (Nbits) * 8.0 / 5);
       else
         NS_FATAL_ERROR ("unsupported code rate");
@@ -0,0 +1,407 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015-2020 IMDEA Networks Institute
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+#include "ns3/codebook-parametric.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("CodebookParametricTest");
+
+/**
+ * Parametric codebook which exposes the configuration of its antenna arrays to the tests.
+ */
+class TestCodebookParametric : public CodebookParametric
+{
+public:
+  /**
+   * Get the first phased antenna array of the codebook.
+   * \return The phased antenna array.
+   */
+  Ptr<ParametricAntennaConfig> GetFirstAntennaConfig (void)
+  {
+    return StaticCast<ParametricAntennaConfig> (m_antennaArrayList[1]);
+  }
+  using Codebook::GetNumberOfAWVs;
+};
+
+/**
+ * Write a parametric codebook file with a single phased antenna array of two elements,
+ * a quasi-omni pattern and two sectors.
+ * \param fileName The name of the codebook file.
+ * \param sectorPhase The phase of the second element in the weights of the second sector.
+ */
+static void
+WriteCodebookFile (std::string fileName, double sectorPhase)
+{
+  std::ofstream file (fileName.c_str ());
+  file << "1\n"         /* Number of RF chains */
+       << "1\n"         /* Number of phased antenna arrays */
+       << "1\n"         /* Antenna ID */
+       << "1\n"         /* RF chain ID */
+       << "0\n"         /* Azimuth orientation */
+       << "0\n"         /* Elevation orientation */
+       << "2\n"         /* Number of antenna elements */
+       << "2\n"         /* Phase quantization bits */
+       << "2\n";        /* Amplitude quantization bits */
+  /* Directivity of a single antenna element */
+  for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
+    {
+      for (uint16_t n = 0; n < ELEVATION_CARDINALITY; n++)
+        {
+          file << (n == 0 ? "" : ",") << 1 + 0.5 * std::cos (m * M_PI / 180);
+        }
+      file << "\n";
+    }
+  /* Steering vector of each antenna element */
+  for (uint16_t l = 0; l < 2; l++)
+    {
+      for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
+        {
+          for (uint16_t n = 0; n < ELEVATION_CARDINALITY; n++)
+            {
+              file << (n == 0 ? "" : ",") << "1," << l * M_PI * std::sin (m * M_PI / 180) * std::sin (n * M_PI / 180);
+            }
+          file << "\n";
+        }
+    }
+  file << "1,0,0,0\n"   /* Quasi-omni weights */
+       << "2\n"         /* Number of sectors */
+       << "1\n2\n2\n"   /* First sector: ID, TX/RX sector, BHI and SLS */
+       << "1,0,1,0\n"
+       << "2\n2\n2\n"   /* Second sector */
+       << "1,0,1," << sectorPhase << "\n";
+  file.close ();
+}
+
+/**
+ * Create a parametric codebook.
+ * \param fileName The name of the codebook file.
+ * \param share Whether the codebook shares the content of the codebooks loaded from the same file.
+ * \return The codebook.
+ */
+static Ptr<TestCodebookParametric>
+CreateCodebook (std::string fileName, bool share)
+{
+  return CreateObjectWithAttributes<TestCodebookParametric> ("ShareCodebook", BooleanValue (share),
+                                                             "FileName", StringValue (fileName));
+}
+
+/**
+ * Get the phased antenna array of a codebook created with WriteCodebookFile.
+ * \param codebook The codebook.
+ * \return The phased antenna array.
+ */
+static Ptr<ParametricAntennaConfig>
+GetAntennaConfig (Ptr<TestCodebookParametric> codebook)
+{
+  return codebook->GetFirstAntennaConfig ();
+}
+
+/**
+ * Get the configuration of a sector of a codebook created with WriteCodebookFile.
+ * \param codebook The codebook.
+ * \param sectorID The ID of the sector.
+ * \return The configuration of the sector.
+ */
+static Ptr<ParametricPatternConfig>
+GetSectorConfig (Ptr<TestCodebookParametric> codebook, SectorID sectorID)
+{
+  return DynamicCast<ParametricPatternConfig> (GetAntennaConfig (codebook)->sectorList[sectorID]);
+}
+
+/**
+ * Get the configuration of an AWV of a codebook created with WriteCodebookFile.
+ * \param codebook The codebook.
+ * \param sectorID The ID of the sector.
+ * \param awvID The ID of the AWV within the sector.
+ * \return The configuration of the AWV.
+ */
+static Ptr<ParametricPatternConfig>
+GetAwvConfig (Ptr<TestCodebookParametric> codebook, SectorID sectorID, AWV_ID awvID)
+{
+  return DynamicCast<ParametricPatternConfig> (GetAntennaConfig (codebook)->sectorList[sectorID]->awvList[awvID]);
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check that parametric codebooks loaded from the same file share their patterns, but
+ * not their sectors and AWVs, and that a codebook which does not share them reads the file.
+ */
+class CodebookParametricSharingTest : public TestCase
+{
+public:
+  CodebookParametricSharingTest ();
+  virtual ~CodebookParametricSharingTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CodebookParametricSharingTest::CodebookParametricSharingTest ()
+  : TestCase ("Check sharing of parametric codebooks loaded from the same file")
+{
+}
+
+CodebookParametricSharingTest::~CodebookParametricSharingTest ()
+{
+}
+
+void
+CodebookParametricSharingTest::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("SharedCodebook.txt");
+  WriteCodebookFile (fileName, 1.5);
+
+  Ptr<TestCodebookParametric> first = CreateCodebook (fileName, true);
+  Ptr<TestCodebookParametric> second = CreateCodebook (fileName, true);
+  Ptr<ParametricPatternConfig> firstSector = GetSectorConfig (first, 1);
+  Ptr<ParametricPatternConfig> secondSector = GetSectorConfig (second, 1);
+  ArrayPattern sharedPattern = firstSector->GetArrayPattern ();
+  Complex sharedValue = firstSector->GetArrayPatternValue (90, 90);
+  NS_TEST_ASSERT_MSG_NE (firstSector, secondSector, "Each codebook must have its own sectors");
+  NS_TEST_EXPECT_MSG_EQ (secondSector->GetArrayPattern (), sharedPattern, "The sector pattern must be shared");
+  NS_TEST_EXPECT_MSG_EQ (GetAntennaConfig (second)->steeringVector, GetAntennaConfig (first)->steeringVector,
+                         "The steering vector must be shared");
+
+  /* Changing the weights of a sector only changes the pattern of this codebook */
+  WeightsVector weights;
+  weights.push_back (Complex (1, 0));
+  weights.push_back (Complex (0, 1));
+  first->UpdateSectorWeights (1, 1, weights);
+  NS_TEST_EXPECT_MSG_NE (firstSector->GetArrayPattern (), sharedPattern, "The updated sector needs its own pattern");
+  NS_TEST_EXPECT_MSG_NE (firstSector->GetArrayPatternValue (90, 90), sharedValue, "The updated pattern must change");
+  NS_TEST_EXPECT_MSG_EQ (secondSector->GetArrayPattern (), sharedPattern, "The other codebook must keep its pattern");
+  NS_TEST_EXPECT_MSG_EQ (secondSector->GetArrayPatternValue (90, 90), sharedValue, "The other codebook must not change");
+  NS_TEST_EXPECT_MSG_EQ (secondSector->GetWeights ()[1], Complex (1, 0), "The other codebook must keep its weights");
+
+  /* Appending an AWV only changes the sector of this codebook */
+  second->AppendBeamRefinementAwv (1, 2, weights);
+  second->AppendBeamRefinementAwv (1, 2, 30, 10);
+  NS_TEST_EXPECT_MSG_EQ (uint16_t (second->GetNumberOfAWVs (1, 2)), 2, "The AWVs must be appended");
+  NS_TEST_EXPECT_MSG_EQ (uint16_t (first->GetNumberOfAWVs (1, 2)), 0, "The other codebook must not get the AWVs");
+
+  /* The codebooks loaded later start from the content of the file */
+  Ptr<TestCodebookParametric> third = CreateCodebook (fileName, true);
+  NS_TEST_EXPECT_MSG_EQ (GetSectorConfig (third, 1)->GetArrayPattern (), sharedPattern, "The sector pattern must be shared");
+  NS_TEST_EXPECT_MSG_EQ (uint16_t (third->GetNumberOfAWVs (1, 2)), 0, "The new codebook must not get the AWVs");
+
+  /* A codebook which does not share its content reads the file again */
+  WriteCodebookFile (fileName, 0.5);
+  Ptr<TestCodebookParametric> shared = CreateCodebook (fileName, true);
+  Ptr<TestCodebookParametric> reloaded = CreateCodebook (fileName, false);
+  NS_TEST_EXPECT_MSG_EQ (GetSectorConfig (shared, 2)->GetWeights ()[1], std::polar (1.0f, 1.5f),
+                         "The shared codebook must keep the content first loaded");
+  NS_TEST_EXPECT_MSG_EQ (GetSectorConfig (reloaded, 2)->GetWeights ()[1], std::polar (1.0f, 0.5f),
+                         "The codebook must be read from the file");
+  NS_TEST_EXPECT_MSG_NE (GetSectorConfig (reloaded, 1)->GetArrayPattern (), sharedPattern,
+                         "The codebook must calculate its own patterns");
+  NS_TEST_EXPECT_MSG_EQ (GetSectorConfig (reloaded, 1)->GetArrayPatternValue (90, 90), sharedValue,
+                         "The pattern of an unchanged sector must not change");
+
+  Simulator::Destroy ();
+  std::remove (fileName.c_str ());
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check that the patterns evaluated on demand are the precalculated patterns.
+ */
+class CodebookParametricLazyPatternTest : public TestCase
+{
+public:
+  CodebookParametricLazyPatternTest ();
+  virtual ~CodebookParametricLazyPatternTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the precalculated pattern and the pattern evaluated on demand over all the directions.
+   * \param precalculated The configuration of the precalculated pattern.
+   * \param lazy The configuration of the pattern evaluated on demand.
+   * \param name The name of the pattern.
+   */
+  void CheckPatterns (Ptr<ParametricPatternConfig> precalculated, Ptr<ParametricPatternConfig> lazy, std::string name);
+};
+
+CodebookParametricLazyPatternTest::CodebookParametricLazyPatternTest ()
+  : TestCase ("Check that parametric patterns evaluated on demand match the precalculated ones")
+{
+}
+
+CodebookParametricLazyPatternTest::~CodebookParametricLazyPatternTest ()
+{
+}
+
+void
+CodebookParametricLazyPatternTest::CheckPatterns (Ptr<ParametricPatternConfig> precalculated,
+                                                  Ptr<ParametricPatternConfig> lazy, std::string name)
+{
+  NS_TEST_ASSERT_MSG_NE (precalculated->GetArrayPattern (), 0, "The " << name << " pattern must be precalculated");
+  NS_TEST_ASSERT_MSG_EQ (lazy->GetArrayPattern (), 0, "The " << name << " pattern must not be precalculated");
+  for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m++)
+    {
+      for (uint16_t n = 0; n < ELEVATION_CARDINALITY; n++)
+        {
+          Complex expected = precalculated->GetArrayPattern (m, n);
+          Complex value = lazy->GetArrayPattern (m, n);
+          NS_TEST_ASSERT_MSG_EQ_TOL (value.real (), expected.real (), 1e-5,
+                                     "The " << name << " pattern differs at (" << m << "," << n << ")");
+          NS_TEST_ASSERT_MSG_EQ_TOL (value.imag (), expected.imag (), 1e-5,
+                                     "The " << name << " pattern differs at (" << m << "," << n << ")");
+        }
+    }
+}
+
+void
+CodebookParametricLazyPatternTest::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("LazyCodebook.txt");
+  WriteCodebookFile (fileName, 1.5);
+
+  Ptr<TestCodebookParametric> precalculated = CreateObjectWithAttributes<TestCodebookParametric> (
+    "PrecalculatePatterns", BooleanValue (true), "FileName", StringValue (fileName));
+  Ptr<TestCodebookParametric> lazy = CreateObjectWithAttributes<TestCodebookParametric> (
+    "PrecalculatePatterns", BooleanValue (false), "FileName", StringValue (fileName));
+
+  Ptr<TestCodebookParametric> codebooks[2] = {precalculated, lazy};
+  for (uint8_t i = 0; i < 2; i++)
+    {
+      codebooks[i]->AppendBeamRefinementAwv (1, 2, 30, 10);
+      codebooks[i]->AppendBeamRefinementAwv (1, 2, 60, 20);
+    }
+  CheckPatterns (GetAntennaConfig (precalculated)->GetQuasiOmniConfig (),
+                 GetAntennaConfig (lazy)->GetQuasiOmniConfig (), "quasi-omni");
+  CheckPatterns (GetSectorConfig (precalculated, 1), GetSectorConfig (lazy, 1), "first sector");
+  CheckPatterns (GetSectorConfig (precalculated, 2), GetSectorConfig (lazy, 2), "second sector");
+  for (AWV_ID awv = 0; awv < 2; awv++)
+    {
+      CheckPatterns (GetAwvConfig (precalculated, 2, awv), GetAwvConfig (lazy, 2, awv), "AWV");
+    }
+
+  /* The patterns follow the updates of the weights */
+  WeightsVector weights;
+  weights.push_back (Complex (0.5, 0));
+  weights.push_back (Complex (0, -1));
+  for (uint8_t i = 0; i < 2; i++)
+    {
+      codebooks[i]->UpdateSectorWeights (1, 1, weights);
+      codebooks[i]->UpdateQuasiOmniWeights (1, weights);
+    }
+  CheckPatterns (GetAntennaConfig (precalculated)->GetQuasiOmniConfig (),
+                 GetAntennaConfig (lazy)->GetQuasiOmniConfig (), "updated quasi-omni");
+  CheckPatterns (GetSectorConfig (precalculated, 1), GetSectorConfig (lazy, 1), "updated sector");
+
+  Simulator::Destroy ();
+  std::remove (fileName.c_str ());
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check that an AWV appended with its weights has the pattern of these weights.
+ */
+class CodebookParametricAwvPatternTest : public TestCase
+{
+public:
+  CodebookParametricAwvPatternTest ();
+  virtual ~CodebookParametricAwvPatternTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CodebookParametricAwvPatternTest::CodebookParametricAwvPatternTest ()
+  : TestCase ("Check the pattern of an AWV given by its weights")
+{
+}
+
+CodebookParametricAwvPatternTest::~CodebookParametricAwvPatternTest ()
+{
+}
+
+void
+CodebookParametricAwvPatternTest::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("AwvCodebook.txt");
+  WriteCodebookFile (fileName, 1.5);
+
+  WeightsVector weights;
+  weights.push_back (Complex (1, 0));
+  weights.push_back (Complex (0, 1));
+  for (uint8_t precalculate = 0; precalculate < 2; precalculate++)
+    {
+      Ptr<TestCodebookParametric> codebook = CreateObjectWithAttributes<TestCodebookParametric> (
+        "PrecalculatePatterns", BooleanValue (precalculate), "FileName", StringValue (fileName));
+      codebook->AppendBeamRefinementAwv (1, 1, weights);
+      Ptr<ParametricAntennaConfig> antennaConfig = GetAntennaConfig (codebook);
+      Ptr<ParametricPatternConfig> awvConfig = GetAwvConfig (codebook, 1, 0);
+      for (uint16_t m = 0; m < AZIMUTH_CARDINALITY; m += 15)
+        {
+          for (uint16_t n = 0; n < ELEVATION_CARDINALITY; n += 15)
+            {
+              Complex expected = (awvConfig->GetWeights ()[0] * antennaConfig->GetSteeringVector (0, m, n)
+                                  + awvConfig->GetWeights ()[1] * antennaConfig->GetSteeringVector (1, m, n))
+                * antennaConfig->GetSingleElementDirectivity (m, n);
+              Complex value = awvConfig->GetArrayPattern (m, n);
+              NS_TEST_ASSERT_MSG_EQ_TOL (value.real (), expected.real (), 1e-5,
+                                         "The AWV pattern differs at (" << m << "," << n << ")");
+              NS_TEST_ASSERT_MSG_EQ_TOL (value.imag (), expected.imag (), 1e-5,
+                                         "The AWV pattern differs at (" << m << "," << n << ")");
+            }
+        }
+    }
+
+  Simulator::Destroy ();
+  std::remove (fileName.c_str ());
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Parametric Codebook Test Suite
+ */
+class CodebookParametricTestSuite : public TestSuite
+{
+public:
+  CodebookParametricTestSuite ();
+};
+
+CodebookParametricTestSuite::CodebookParametricTestSuite ()
+  : TestSuite ("wifi-codebook-parametric", UNIT)
+{
+  AddTestCase (new CodebookParametricSharingTest, TestCase::QUICK);
+  AddTestCase (new CodebookParametricLazyPatternTest, TestCase::QUICK);
+  AddTestCase (new CodebookParametricAwvPatternTest, TestCase::QUICK);
+}
+
+static CodebookParametricTestSuite g_codebookParametricTestSuite; ///< the test suite
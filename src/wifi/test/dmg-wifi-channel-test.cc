@@ -0,0 +1,262 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015-2020 IMDEA Networks Institute
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/codebook-analytical.h"
+#include "ns3/dmg-adhoc-wifi-mac.h"
+#include "ns3/dmg-wifi-channel.h"
+#include "ns3/dmg-wifi-helper.h"
+#include "ns3/dmg-wifi-mac-helper.h"
+#include "ns3/dmg-wifi-phy.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-psdu.h"
+#include "ns3/wifi-utils.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DmgWifiChannelTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check that restricting the fan-out of the TRN subfields to the receivers synchronized to
+ * the sender leaves the SNR reported for a BRP packet unchanged and schedules fewer events.
+ *
+ * A BRP packet carrying a TRN field is sent to a receiver one meter away while a third station,
+ * too far away to synchronize to the sender, shares the channel.
+ */
+class DmgTrnFieldFanOutTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param standard The standard of the stations, either 802.11ad or 802.11ay.
+   * \param packetType The type of the TRN field, either TRN-T or TRN-R.
+   */
+  DmgTrnFieldFanOutTest (WifiPhyStandard standard, PacketType packetType);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Send the BRP packet and record the SNR reported by the receiver.
+   * \param restrictFanOut Whether the channel delivers the TRN subfields to the synchronized receivers only.
+   * \return The number of events executed by the simulation.
+   */
+  uint64_t RunBrp (bool restrictFanOut);
+  /**
+   * Point the sector of each station toward the other one.
+   * \param txMac The MAC of the sender.
+   * \param rxMac The MAC of the receiver.
+   */
+  void SetAntennaConfigurations (Ptr<DmgAdhocWifiMac> txMac, Ptr<DmgAdhocWifiMac> rxMac);
+  /**
+   * Send a PPDU carrying a TRN field.
+   * \param sender The PHY of the sender.
+   * \param receiver The PHY of the receiver.
+   * \param txVector The TXVECTOR of the PPDU.
+   */
+  void SendBrpPacket (Ptr<DmgWifiPhy> sender, Ptr<DmgWifiPhy> receiver, WifiTxVector txVector);
+  /**
+   * Record the SNR reported for a TRN subfield.
+   * \param antennaID The ID of the phased antenna array.
+   * \param sectorID The ID of the sector.
+   * \param trnUnitsRemaining The number of remaining TRN units.
+   * \param subfieldsRemaining The number of remaining TRN subfields within the unit.
+   * \param pSubfieldsRemaining The number of remaining P subfields.
+   * \param snr The SNR of the TRN subfield in linear scale.
+   * \param isTxTrn Whether the TRN subfield trains the transmit pattern.
+   * \param index The index of the AWV.
+   */
+  void ReportSnr (AntennaID antennaID, SectorID sectorID, uint8_t trnUnitsRemaining, uint8_t subfieldsRemaining,
+                  uint8_t pSubfieldsRemaining, double snr, bool isTxTrn, uint8_t index);
+
+  WifiPhyStandard m_standard;         //!< The standard of the stations.
+  PacketType m_packetType;            //!< The type of the TRN field.
+  std::vector<double> m_snrValues;    //!< The SNR values reported by the receiver.
+};
+
+DmgTrnFieldFanOutTest::DmgTrnFieldFanOutTest (WifiPhyStandard standard, PacketType packetType)
+  : TestCase (std::string ("Check TRN subfield fan-out for ")
+              + (standard == WIFI_PHY_STANDARD_80211ad ? "DMG " : "EDMG ")
+              + (packetType == TRN_T ? "TRN-T" : "TRN-R")),
+    m_standard (standard),
+    m_packetType (packetType)
+{
+}
+
+void
+DmgTrnFieldFanOutTest::ReportSnr (AntennaID antennaID, SectorID sectorID, uint8_t trnUnitsRemaining,
+                                  uint8_t subfieldsRemaining, uint8_t pSubfieldsRemaining, double snr,
+                                  bool isTxTrn, uint8_t index)
+{
+  m_snrValues.push_back (snr);
+}
+
+void
+DmgTrnFieldFanOutTest::SetAntennaConfigurations (Ptr<DmgAdhocWifiMac> txMac, Ptr<DmgAdhocWifiMac> rxMac)
+{
+  txMac->AddAntennaConfig (1, 1, 1, 1, rxMac->GetAddress ());
+  rxMac->AddAntennaConfig (5, 1, 5, 1, txMac->GetAddress ());
+  txMac->SteerAntennaToward (rxMac->GetAddress ());
+  rxMac->SteerAntennaToward (txMac->GetAddress ());
+}
+
+void
+DmgTrnFieldFanOutTest::SendBrpPacket (Ptr<DmgWifiPhy> sender, Ptr<DmgWifiPhy> receiver, WifiTxVector txVector)
+{
+  /* Replace the callback registered by the MAC when it is initialized */
+  receiver->RegisterReportSnrCallback (MakeCallback (&DmgTrnFieldFanOutTest::ReportSnr, this));
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+  hdr.SetAddr1 (Mac48Address ("00:00:00:00:00:99"));
+  hdr.SetAddr2 (txVector.GetSender ());
+  sender->Send (Create<WifiPsdu> (Create<Packet> (100), hdr), txVector);
+}
+
+uint64_t
+DmgTrnFieldFanOutTest::RunBrp (bool restrictFanOut)
+{
+  m_snrValues.clear ();
+  DmgWifiHelper wifi;
+  wifi.SetStandard (m_standard);
+  wifi.SetCodebook ("ns3::CodebookAnalytical",
+                    "CodebookType", EnumValue (SIMPLE_CODEBOOK),
+                    "Antennas", UintegerValue (1),
+                    "Sectors", UintegerValue (8),
+                    "AWVs", UintegerValue (8));
+
+  DmgWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (60.48e9));
+  Ptr<DmgWifiChannel> channel = wifiChannel.Create ();
+  channel->SetAttribute ("RestrictTrnFieldFanOut", BooleanValue (restrictFanOut));
+
+  DmgWifiPhyHelper wifiPhy = DmgWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (channel);
+  if (m_standard == WIFI_PHY_STANDARD_80211ay)
+    {
+      wifiPhy.SetErrorRateModel ("ns3::DmgErrorModel",
+                                 "FileName", StringValue ("WigigFiles/ErrorModel/LookupTable_1458_ay.txt"));
+    }
+
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+  wifiMac.SetType ("ns3::DmgAdhocWifiMac",
+                   "EDMGSupported", BooleanValue (m_standard == WIFI_PHY_STANDARD_80211ay));
+
+  /* The sender, the receiver and a station too far away to synchronize to the sender */
+  NodeContainer nodes;
+  nodes.Create (3);
+  Vector positions[3] = {Vector (0.0, 0.0, 0.0), Vector (1.0, 0.0, 0.0), Vector (0.0, 10000.0, 0.0)};
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (positions[i]);
+      nodes.Get (i)->AggregateObject (mobility);
+    }
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+
+  Ptr<WifiNetDevice> txDevice = DynamicCast<WifiNetDevice> (devices.Get (0));
+  Ptr<WifiNetDevice> rxDevice = DynamicCast<WifiNetDevice> (devices.Get (1));
+  Ptr<DmgAdhocWifiMac> txMac = DynamicCast<DmgAdhocWifiMac> (txDevice->GetMac ());
+  Ptr<DmgAdhocWifiMac> rxMac = DynamicCast<DmgAdhocWifiMac> (rxDevice->GetMac ());
+  Ptr<DmgWifiPhy> txPhy = DynamicCast<DmgWifiPhy> (txDevice->GetPhy ());
+  Ptr<DmgWifiPhy> rxPhy = DynamicCast<DmgWifiPhy> (rxDevice->GetPhy ());
+
+  /* The codebooks are initialized with the MACs at the start of the simulation */
+  Simulator::Schedule (MicroSeconds (1), &DmgTrnFieldFanOutTest::SetAntennaConfigurations, this, txMac, rxMac);
+
+  WifiMode mode = WifiMode (m_standard == WIFI_PHY_STANDARD_80211ad ? "DMG_MCS1" : "EDMG_SC_MCS1");
+  WifiTxVector txVector;
+  txVector.SetMode (mode);
+  txVector.SetPreambleType (GetWiGigPreamble (mode.GetModulationClass ()));
+  txVector.SetTxPowerLevel (0);
+  txVector.SetChannelWidth (txPhy->GetChannelWidth ());
+  txVector.SetChBandwidth (txPhy->GetChannelConfiguration ());
+  txVector.SetPacketType (m_packetType);
+  txVector.SetSender (txMac->GetAddress ());
+  if (m_standard == WIFI_PHY_STANDARD_80211ad)
+    {
+      txVector.SetTrainngFieldLength (8);
+    }
+  else
+    {
+      txVector.SetEDMGTrainingFieldLength (2);
+      txVector.Set_TRN_SEQ_LEN (txMac->GetTrnSeqLength ());
+      txVector.Set_EDMG_TRN_P (txMac->Get_EDMG_TRN_P ());
+      txVector.Set_EDMG_TRN_M (txMac->Get_EDMG_TRN_M ());
+      txVector.Set_EDMG_TRN_N (txMac->Get_EDMG_TRN_N ());
+      txVector.Set_RxPerTxUnits (txMac->Get_RxPerTxUnits ());
+    }
+  Simulator::Schedule (MicroSeconds (10), &DmgTrnFieldFanOutTest::SendBrpPacket, this, txPhy, rxPhy, txVector);
+
+  Simulator::Run ();
+  uint64_t events = Simulator::GetEventCount ();
+  Simulator::Destroy ();
+  return events;
+}
+
+void
+DmgTrnFieldFanOutTest::DoRun (void)
+{
+  uint64_t broadcastEvents = RunBrp (false);
+  std::vector<double> broadcastSnr = m_snrValues;
+  uint64_t restrictedEvents = RunBrp (true);
+  std::vector<double> restrictedSnr = m_snrValues;
+
+  NS_TEST_ASSERT_MSG_NE (broadcastSnr.size (), 0, "The receiver must report the SNR of the TRN subfields");
+  NS_TEST_ASSERT_MSG_EQ (restrictedSnr.size (), broadcastSnr.size (), "The same TRN subfields must be reported");
+  for (size_t i = 0; i < broadcastSnr.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (restrictedSnr[i], broadcastSnr[i], "The SNR of TRN subfield " << i << " must not change");
+    }
+  NS_TEST_EXPECT_MSG_LT (restrictedEvents, broadcastEvents, "Restricting the fan-out must schedule fewer events");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief DMG Wifi Channel Test Suite
+ */
+class DmgWifiChannelTestSuite : public TestSuite
+{
+public:
+  DmgWifiChannelTestSuite ();
+};
+
+DmgWifiChannelTestSuite::DmgWifiChannelTestSuite ()
+  : TestSuite ("wifi-dmg-channel", UNIT)
+{
+  AddTestCase (new DmgTrnFieldFanOutTest (WIFI_PHY_STANDARD_80211ad, TRN_T), TestCase::QUICK);
+  AddTestCase (new DmgTrnFieldFanOutTest (WIFI_PHY_STANDARD_80211ad, TRN_R), TestCase::QUICK);
+  AddTestCase (new DmgTrnFieldFanOutTest (WIFI_PHY_STANDARD_80211ay, TRN_T), TestCase::QUICK);
+  AddTestCase (new DmgTrnFieldFanOutTest (WIFI_PHY_STANDARD_80211ay, TRN_R), TestCase::QUICK);
+}
+
+static DmgWifiChannelTestSuite g_dmgWifiChannelTestSuite; ///< the test suite
@@ -0,0 +1,260 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/mimo-assignment-solver.h"
+
+#include <algorithm>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MimoAssignmentSolverTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check that the MIMO assignment solver returns the same assignment as a brute-force search
+ * over all the valid combinations of Tx-Rx pairs, listed in the order of DmgWifiMac::FindAllValidTxRxPairs.
+ */
+class MimoAssignmentSolverTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param name The name of the test case.
+   * \param snrLevels The number of distinct integer SNR values to draw from, or 0 to draw continuous SNR values.
+   * \param missingProbability The probability that the SNR of a Tx-Rx pair is not set.
+   */
+  MimoAssignmentSolverTest (std::string name, uint16_t snrLevels, double missingProbability);
+  virtual ~MimoAssignmentSolverTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check a small assignment problem with a known solution.
+   */
+  void CheckKnownAssignment (void);
+  /**
+   * Find the assignment that maximizes the minimum per-stream SNR by checking every valid combination
+   * of Tx-Rx pairs. Among the optimal combinations, the first one listed is kept.
+   * \param nRx The number of Rx antennas.
+   * \param snr The SNR of each Tx-Rx pair.
+   * \param valid Whether each Tx-Rx pair has been set.
+   * \param nStreams The number of streams.
+   * \param assignment The indexes of the Tx-Rx pairs of the best combination.
+   * \param maxMinSnr The minimum per-stream SNR of the best combination.
+   * \return True if a valid combination exists, false otherwise.
+   */
+  bool FindBruteForceAssignment (uint8_t nRx, const std::vector<double> &snr, const std::vector<bool> &valid,
+                                 uint8_t nStreams, std::vector<uint16_t> &assignment, double &maxMinSnr);
+  /**
+   * Recursively enumerate the combinations of Tx-Rx pairs in ascending index order.
+   * \param offset The position of the first Tx-Rx pair that can be added.
+   * \param nStreams The number of Tx-Rx pairs still to be added.
+   * \param nRx The number of Rx antennas.
+   * \param indexes The indexes of the Tx-Rx pairs that have been set.
+   * \param snr The SNR of each Tx-Rx pair.
+   * \param current The combination being built.
+   * \param assignment The indexes of the Tx-Rx pairs of the best combination so far.
+   * \param maxMinSnr The minimum per-stream SNR of the best combination so far.
+   * \param found Whether a valid combination has been found so far.
+   */
+  void Enumerate (uint16_t offset, uint8_t nStreams, uint8_t nRx, const std::vector<uint16_t> &indexes,
+                  const std::vector<double> &snr, std::vector<uint16_t> &current,
+                  std::vector<uint16_t> &assignment, double &maxMinSnr, bool &found);
+
+  uint16_t m_snrLevels;         //!< The number of distinct integer SNR values, 0 for continuous values.
+  double m_missingProbability;  //!< The probability that a Tx-Rx pair is not set.
+};
+
+MimoAssignmentSolverTest::MimoAssignmentSolverTest (std::string name, uint16_t snrLevels, double missingProbability)
+  : TestCase (name),
+    m_snrLevels (snrLevels),
+    m_missingProbability (missingProbability)
+{
+}
+
+MimoAssignmentSolverTest::~MimoAssignmentSolverTest ()
+{
+}
+
+void
+MimoAssignmentSolverTest::Enumerate (uint16_t offset, uint8_t nStreams, uint8_t nRx, const std::vector<uint16_t> &indexes,
+                                     const std::vector<double> &snr, std::vector<uint16_t> &current,
+                                     std::vector<uint16_t> &assignment, double &maxMinSnr, bool &found)
+{
+  if (nStreams == 0)
+    {
+      double minSnr = 0;
+      for (uint16_t i = 0; i < current.size (); i++)
+        {
+          for (uint16_t j = i + 1; j < current.size (); j++)
+            {
+              if ((current[i] / nRx == current[j] / nRx) || (current[i] % nRx == current[j] % nRx))
+                {
+                  return;
+                }
+            }
+          minSnr = (i == 0) ? snr[current[i]] : std::min (minSnr, snr[current[i]]);
+        }
+      if (!found || minSnr > maxMinSnr)
+        {
+          assignment = current;
+          maxMinSnr = minSnr;
+          found = true;
+        }
+      return;
+    }
+  for (uint16_t i = offset; i + nStreams <= indexes.size (); i++)
+    {
+      current.push_back (indexes[i]);
+      Enumerate (i + 1, nStreams - 1, nRx, indexes, snr, current, assignment, maxMinSnr, found);
+      current.pop_back ();
+    }
+}
+
+bool
+MimoAssignmentSolverTest::FindBruteForceAssignment (uint8_t nRx, const std::vector<double> &snr, const std::vector<bool> &valid,
+                                                    uint8_t nStreams, std::vector<uint16_t> &assignment, double &maxMinSnr)
+{
+  std::vector<uint16_t> indexes;
+  for (uint16_t idx = 0; idx < valid.size (); idx++)
+    {
+      if (valid[idx])
+        {
+          indexes.push_back (idx);
+        }
+    }
+  std::vector<uint16_t> current;
+  bool found = false;
+  assignment.clear ();
+  Enumerate (0, nStreams, nRx, indexes, snr, current, assignment, maxMinSnr, found);
+  return found;
+}
+
+void
+MimoAssignmentSolverTest::CheckKnownAssignment (void)
+{
+  /* Pairing each Tx antenna with its strongest Rx antenna gives the best minimum SNR */
+  MimoAssignmentSolver solver (2, 2);
+  solver.SetSnr (0, 0, 10);
+  solver.SetSnr (0, 1, 1);
+  solver.SetSnr (1, 0, 2);
+  solver.SetSnr (1, 1, 9);
+  NS_TEST_ASSERT_MSG_EQ (solver.Solve (2), true, "An assignment must exist");
+  NS_TEST_EXPECT_MSG_EQ (solver.GetMaxMinSnr (), 9, "Wrong minimum per-stream SNR");
+  NS_TEST_ASSERT_MSG_EQ (solver.GetAssignment ().size (), 2, "Wrong number of streams");
+  NS_TEST_EXPECT_MSG_EQ (solver.GetAssignment ()[0], 0, "Wrong first Tx-Rx pair");
+  NS_TEST_EXPECT_MSG_EQ (solver.GetAssignment ()[1], 3, "Wrong second Tx-Rx pair");
+
+  /* Without the strongest pair of the second Tx antenna, only the crossed pairing remains */
+  solver.Clear ();
+  solver.SetSnr (0, 0, 10);
+  solver.SetSnr (0, 1, 1);
+  solver.SetSnr (1, 0, 2);
+  NS_TEST_ASSERT_MSG_EQ (solver.Solve (2), true, "An assignment must exist");
+  NS_TEST_EXPECT_MSG_EQ (solver.GetMaxMinSnr (), 1, "Wrong minimum per-stream SNR");
+  NS_TEST_EXPECT_MSG_EQ (solver.GetAssignment ()[0], 1, "Wrong first Tx-Rx pair");
+  NS_TEST_EXPECT_MSG_EQ (solver.GetAssignment ()[1], 2, "Wrong second Tx-Rx pair");
+
+  /* Both Tx antennas can only reach the first Rx antenna */
+  solver.Clear ();
+  solver.SetSnr (0, 0, 10);
+  solver.SetSnr (1, 0, 2);
+  NS_TEST_EXPECT_MSG_EQ (solver.Solve (2), false, "No assignment with two streams exists");
+  NS_TEST_EXPECT_MSG_EQ (solver.GetAssignment ().empty (), true, "No assignment expected");
+  NS_TEST_EXPECT_MSG_EQ (solver.Solve (3), false, "More streams than antennas");
+}
+
+void
+MimoAssignmentSolverTest::DoRun (void)
+{
+  CheckKnownAssignment ();
+
+  Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable> ();
+  rv->SetStream (1);
+  for (uint16_t iteration = 0; iteration < 500; iteration++)
+    {
+      uint8_t nTx = rv->GetInteger (1, 4);
+      uint8_t nRx = rv->GetInteger (1, 4);
+      MimoAssignmentSolver solver (nTx, nRx);
+      /* Fill the solver twice to check that Clear removes all the Tx-Rx pairs */
+      for (uint8_t round = 0; round < 2; round++)
+        {
+          std::vector<double> snr (nTx * nRx, 0);
+          std::vector<bool> valid (nTx * nRx, false);
+          solver.Clear ();
+          for (uint8_t tx = 0; tx < nTx; tx++)
+            {
+              for (uint8_t rx = 0; rx < nRx; rx++)
+                {
+                  uint16_t idx = tx * nRx + rx;
+                  snr[idx] = (m_snrLevels > 0) ? rv->GetInteger (0, m_snrLevels - 1) : rv->GetValue (-10, 30);
+                  valid[idx] = (rv->GetValue () >= m_missingProbability);
+                  if (valid[idx])
+                    {
+                      solver.SetSnr (tx, rx, snr[idx]);
+                    }
+                }
+            }
+
+          for (uint8_t nStreams = 1; nStreams <= std::min (nTx, nRx); nStreams++)
+            {
+              std::vector<uint16_t> expectedAssignment;
+              double expectedMaxMinSnr = 0;
+              bool expected = FindBruteForceAssignment (nRx, snr, valid, nStreams, expectedAssignment, expectedMaxMinSnr);
+              bool solved = solver.Solve (nStreams);
+              NS_TEST_ASSERT_MSG_EQ (solved, expected, "Feasibility differs for " << +nTx << "x" << +nRx
+                                     << " with " << +nStreams << " streams");
+              if (!expected)
+                {
+                  continue;
+                }
+              NS_TEST_ASSERT_MSG_EQ (solver.GetMaxMinSnr (), expectedMaxMinSnr, "Minimum per-stream SNR differs for "
+                                     << +nTx << "x" << +nRx << " with " << +nStreams << " streams");
+              NS_TEST_ASSERT_MSG_EQ ((solver.GetAssignment () == expectedAssignment), true, "Assignment differs for "
+                                     << +nTx << "x" << +nRx << " with " << +nStreams << " streams");
+              NS_TEST_ASSERT_MSG_GT_OR_EQ (solver.GetUpperBound (nStreams), expectedMaxMinSnr,
+                                           "Upper bound below the optimal minimum per-stream SNR");
+            }
+        }
+    }
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief MIMO Assignment Solver Test Suite
+ */
+class MimoAssignmentSolverTestSuite : public TestSuite
+{
+public:
+  MimoAssignmentSolverTestSuite ();
+};
+
+MimoAssignmentSolverTestSuite::MimoAssignmentSolverTestSuite ()
+  : TestSuite ("wifi-mimo-assignment-solver", UNIT)
+{
+  AddTestCase (new MimoAssignmentSolverTest ("Check random SNRs against brute force", 0, 0), TestCase::QUICK);
+  AddTestCase (new MimoAssignmentSolverTest ("Check tied SNRs against brute force", 3, 0), TestCase::QUICK);
+  AddTestCase (new MimoAssignmentSolverTest ("Check missing Tx-Rx pairs against brute force", 4, 0.3), TestCase::QUICK);
+}
+
+static MimoAssignmentSolverTestSuite g_mimoAssignmentSolverTestSuite; ///< the test suite
@@ -0,0 +1,182 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2015-2020 IMDEA Networks Institute
+ * Copyright (c) 2018-2020 National Institute of Standards and Technology (NIST)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/qd-channel-store.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("QdChannelStoreTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check that a Q-D text file converted into the binary Q-D format exposes
+ * the same records as the text file, including channels without multipath.
+ */
+class QdChannelStoreConversionTest : public TestCase
+{
+public:
+  QdChannelStoreConversionTest ();
+  virtual ~QdChannelStoreConversionTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare two records of the Q-D channel.
+   * \param a The first record.
+   * \param b The second record.
+   */
+  void CheckRecords (const QdChannelRecord &a, const QdChannelRecord &b);
+};
+
+QdChannelStoreConversionTest::QdChannelStoreConversionTest ()
+  : TestCase ("Check conversion of Q-D text files into the binary Q-D format")
+{
+}
+
+QdChannelStoreConversionTest::~QdChannelStoreConversionTest ()
+{
+}
+
+void
+QdChannelStoreConversionTest::CheckRecords (const QdChannelRecord &a, const QdChannelRecord &b)
+{
+  NS_TEST_ASSERT_MSG_EQ (a.numPaths, b.numPaths, "Number of multipath components differs");
+  for (uint32_t k = 0; k < a.numPaths; k++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (a.delay[k], b.delay[k], "Delay differs for path " << k);
+      NS_TEST_EXPECT_MSG_EQ (a.pathLoss[k], b.pathLoss[k], "Path loss differs for path " << k);
+      NS_TEST_EXPECT_MSG_EQ (a.phase[k], b.phase[k], "Phase differs for path " << k);
+      NS_TEST_EXPECT_MSG_EQ (a.aodElevation[k], b.aodElevation[k], "AoD elevation differs for path " << k);
+      NS_TEST_EXPECT_MSG_EQ (a.aodAzimuth[k], b.aodAzimuth[k], "AoD azimuth differs for path " << k);
+      NS_TEST_EXPECT_MSG_EQ (a.aoaElevation[k], b.aoaElevation[k], "AoA elevation differs for path " << k);
+      NS_TEST_EXPECT_MSG_EQ (a.aoaAzimuth[k], b.aoaAzimuth[k], "AoA azimuth differs for path " << k);
+    }
+}
+
+void
+QdChannelStoreConversionTest::DoRun (void)
+{
+  /* Two traces between a device with two antennas and a device with a single antenna,
+   * the second channel of the first trace has no multipath component. The last record
+   * is truncated and must be ignored. */
+  std::string textFile = CreateTempDirFilename ("Tx0Rx1.txt");
+  std::ofstream file (textFile.c_str ());
+  file << "2\n"
+       << "2.6697e-08,4.4955e-08\n"
+       << "-86.0764,-100.6027\n"
+       << "0,3.1416\n"
+       << "96.4521,93.8264\n"
+       << "212.882,240.2202\n"
+       << "83.5479,86.1736\n"
+       << "32.882,299.7798\n"
+       << "0\n"
+       << "1\n"
+       << "2.6606e-08\n"
+       << "-86.0469\n"
+       << "0\n"
+       << "96.4742\n"
+       << "212.1\n"
+       << "83.5\n"
+       << "32.8\n"
+       << "3\n"
+       << "2.6606e-08,1e-08,2e-08\n"
+       << "-86.0469,-90,-91\n"
+       << "0,0,0\n"
+       << "96.4742,90,91\n"
+       << "212.1,10,11\n"
+       << "83.5,20,21\n"
+       << "32.8,30,31\n"
+       << "1\n"
+       << "1e-08\n";
+  file.close ();
+
+  std::string binaryFile = QdChannelStore::GetBinaryFileName (textFile);
+  NS_TEST_ASSERT_MSG_EQ (binaryFile, CreateTempDirFilename ("Tx0Rx1.bin"), "Unexpected binary file name");
+  NS_TEST_ASSERT_MSG_EQ (QdChannelStore::ConvertTextFile (textFile, binaryFile), true, "Conversion failed");
+
+  Ptr<QdChannelStore> textStore = Create<QdChannelStore> ();
+  Ptr<QdChannelStore> binaryStore = Create<QdChannelStore> ();
+  NS_TEST_ASSERT_MSG_EQ (textStore->LoadTextFile (textFile, 2, 1), true, "Cannot load the text file");
+  NS_TEST_ASSERT_MSG_EQ (binaryStore->Open (binaryFile, 2, 1), true, "Cannot map the binary file");
+  NS_TEST_ASSERT_MSG_EQ (binaryStore->GetNumRecords (), 4, "Truncated record must be dropped");
+  NS_TEST_ASSERT_MSG_EQ (binaryStore->GetNumTraces (), 2, "Unexpected number of traces");
+  NS_TEST_ASSERT_MSG_EQ (textStore->GetNumTraces (), binaryStore->GetNumTraces (), "Number of traces differs");
+
+  for (uint32_t trace = 0; trace < binaryStore->GetNumTraces (); trace++)
+    {
+      for (AntennaID txAntenna = 1; txAntenna <= 2; txAntenna++)
+        {
+          CheckRecords (textStore->GetRecord (trace, txAntenna, 1), binaryStore->GetRecord (trace, txAntenna, 1));
+        }
+    }
+
+  QdChannelRecord record = binaryStore->GetRecord (0, 1, 1);
+  NS_TEST_EXPECT_MSG_EQ (record.delay[1], 4.4955e-08f, "Wrong delay");
+  NS_TEST_EXPECT_MSG_EQ (record.phase[1], 3.1416f, "Wrong phase");
+  NS_TEST_EXPECT_MSG_EQ (record.aoaAzimuth[1], 299.7798f, "Wrong AoA azimuth");
+  NS_TEST_EXPECT_MSG_EQ (binaryStore->GetRecord (0, 2, 1).numPaths, 0, "Channel without multipath expected");
+  NS_TEST_EXPECT_MSG_EQ (binaryStore->GetRecord (1, 2, 1).aoaElevation[2], 21.0f, "Wrong AoA elevation");
+
+  /* The binary file is up to date with the text file it was converted from */
+  Ptr<QdChannelStore> checkedStore = Create<QdChannelStore> ();
+  NS_TEST_EXPECT_MSG_EQ (checkedStore->Open (binaryFile, textFile, 2, 1), true, "Up to date binary file must be mapped");
+  checkedStore->Close ();
+
+  /* Once the text file changes, the binary file is stale and must be ignored */
+  std::ofstream appendFile (textFile.c_str (), std::ofstream::app);
+  appendFile << "0\n";
+  appendFile.close ();
+  NS_TEST_EXPECT_MSG_EQ (checkedStore->Open (binaryFile, textFile, 2, 1), false, "Stale binary file must be rejected");
+  NS_TEST_EXPECT_MSG_EQ (checkedStore->IsOpen (), false, "Stale binary file must not stay mapped");
+
+  /* A text file is not a valid binary Q-D file */
+  Ptr<QdChannelStore> invalidStore = Create<QdChannelStore> ();
+  NS_TEST_EXPECT_MSG_EQ (invalidStore->Open (textFile, 2, 1), false, "Text file must be rejected");
+
+  binaryStore->Close ();
+  std::remove (textFile.c_str ());
+  std::remove (binaryFile.c_str ());
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Q-D Channel Store Test Suite
+ */
+class QdChannelStoreTestSuite : public TestSuite
+{
+public:
+  QdChannelStoreTestSuite ();
+};
+
+QdChannelStoreTestSuite::QdChannelStoreTestSuite ()
+  : TestSuite ("wifi-qd-channel-store", UNIT)
+{
+  AddTestCase (new QdChannelStoreConversionTest, TestCase::QUICK);
+}
+
+static QdChannelStoreTestSuite g_qdChannelStoreTestSuite; ///< the test suite
@@ -21,9 +21,16 @@
 #include "ns3/test.h"
 #include "ns3/nist-error-rate-model.h"
 #include "ns3/dsss-error-rate-model.h"
+#include "ns3/dmg-error-model.h"
+#include "ns3/dmg-wifi-phy.h"
+#include "ns3/string.h"
 #include "ns3/wifi-phy.h"
 #include "ns3/wifi-utils.h"
 
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
 using namespace ns3;
 
 double
@@ -450,6 +457,85 @@ WifiErrorRateModelsTestCaseMimo::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (chunkSuccess, sisoChunkSuccess, 0.000001, "CSR not within tolerance for 4x4:4 MIMO");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Wifi Error Rate Models Test Case DMG
+ */
+class WifiErrorRateModelsTestCaseDmg : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseDmg ();
+  virtual ~WifiErrorRateModelsTestCaseDmg ();
+
+private:
+  virtual void DoRun (void);
+};
+
+WifiErrorRateModelsTestCaseDmg::WifiErrorRateModelsTestCaseDmg ()
+  : TestCase ("WifiErrorRateModel test case DMG")
+{
+}
+
+WifiErrorRateModelsTestCaseDmg::~WifiErrorRateModelsTestCaseDmg ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseDmg::DoRun (void)
+{
+  /* SNR to BER table of DMG MCS1 with five datapoints spaced by 0.5 dB from -1 dB to 1 dB */
+  std::string fileName = CreateTempDirFilename ("dmg-error-model.txt");
+  std::ofstream file (fileName.c_str ());
+  file << "1" << std::endl
+       << "1" << std::endl
+       << "0.5" << std::endl
+       << "1" << std::endl
+       << "-1" << std::endl
+       << "1" << std::endl
+       << "1" << std::endl
+       << "0" << std::endl
+       << "5" << std::endl
+       << "-1,-0.5,0,0.5,1" << std::endl
+       << "1,0.1,0.01,0.001,0" << std::endl;
+  file.close ();
+
+  Ptr<DmgErrorModel> model = CreateObject<DmgErrorModel> ();
+  model->SetAttribute ("FileName", StringValue (fileName));
+  WifiMode mode = DmgWifiPhy::GetDMG_MCS1 ();
+  WifiTxVector txVector;
+  txVector.SetMode (mode);
+
+  /* Datapoints of the table are returned as they are */
+  double psr = model->GetChunkSuccessRate (mode, txVector, DbToRatio (-0.5), 1);
+  NS_TEST_ASSERT_MSG_EQ_TOL (psr, 0.9, 1e-12, "PSR not within tolerance at an SNR datapoint");
+  psr = model->GetChunkSuccessRate (mode, txVector, DbToRatio (0.5), 1);
+  NS_TEST_ASSERT_MSG_EQ_TOL (psr, 0.999, 1e-12, "PSR not within tolerance at an SNR datapoint");
+
+  /* Between two datapoints the BER is linearly interpolated */
+  psr = model->GetChunkSuccessRate (mode, txVector, DbToRatio (-0.25), 1);
+  NS_TEST_ASSERT_MSG_EQ_TOL (psr, 0.945, 1e-12, "PSR not within tolerance between SNR datapoints");
+  psr = model->GetChunkSuccessRate (mode, txVector, DbToRatio (0.1), 1);
+  NS_TEST_ASSERT_MSG_EQ_TOL (psr, 0.9918, 1e-12, "PSR not within tolerance between SNR datapoints");
+  psr = model->GetChunkSuccessRate (mode, txVector, DbToRatio (-0.25), 100);
+  NS_TEST_ASSERT_MSG_EQ_TOL (psr, std::pow (0.945, 100), 1e-12, "PSR not within tolerance for a multi-bit chunk");
+
+  /* Outside of the table the BER is clamped to the BER of the minimum or maximum SNR */
+  psr = model->GetChunkSuccessRate (mode, txVector, DbToRatio (-1), 1);
+  NS_TEST_ASSERT_MSG_EQ_TOL (psr, 0, 1e-12, "PSR should be zero at the minimum SNR");
+  psr = model->GetChunkSuccessRate (mode, txVector, DbToRatio (-10), 1000);
+  NS_TEST_ASSERT_MSG_EQ (psr, 0, "PSR should be zero below the minimum SNR");
+  psr = model->GetChunkSuccessRate (mode, txVector, DbToRatio (-10), 0);
+  NS_TEST_ASSERT_MSG_EQ (psr, 1, "PSR of an empty chunk should be one");
+  psr = model->GetChunkSuccessRate (mode, txVector, DbToRatio (1), 1);
+  NS_TEST_ASSERT_MSG_EQ_TOL (psr, 1, 1e-12, "PSR should be one at the maximum SNR");
+  psr = model->GetChunkSuccessRate (mode, txVector, DbToRatio (10), 1000);
+  NS_TEST_ASSERT_MSG_EQ (psr, 1, "PSR should be one above the maximum SNR");
+
+  std::remove (fileName.c_str ());
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -468,6 +554,7 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseMimo, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseDmg, TestCase::QUICK);
 }
 
 static WifiErrorRateModelsTestSuite wifiErrorRateModelsTestSuite; ///< the test suite